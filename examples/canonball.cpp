@@ -88,6 +88,9 @@ class canon_t {
         rect_t m_barrel_end;
         point_t rot_point;
         circle_seg_ref_t m_platform;
+        /** Broadphase index of agobjects(), re-keyed each tick */
+        grid_index_t m_agrid;
+        geom_list_t m_agrid_res;
         int m_cp = 0;
         int m_score = 0;
     public:
@@ -101,7 +104,8 @@ class canon_t {
         m_ball(player_balls_min),
         m_barrel_start(point_t(0, radius*0.5f), barrel_start_width, barrel_start_height),
         m_barrel_end(point_t(m_barrel_start.m_tr.x, m_barrel_start.m_tr.y - barrel_start_height * ((1.0f / 3) / 2)),
-                     barrel_end_width, barrel_end_height) {
+                     barrel_end_width, barrel_end_height),
+        m_agrid(basket_height) {
             m_barrel_start.move(m_center_half_circle);
             m_barrel_end.move(m_center_half_circle);
             rot_point = point_t(m_barrel_start.m_tl.x, m_barrel_start.m_tl.y - barrel_start_height * 0.5f);
@@ -162,6 +166,23 @@ class canon_t {
             return result;
         }
 
+        /** Re-keys m_agrid by the current agobjects(), rebuilt if objects were added or removed. */
+        void update_agrid() {
+            const ageom_list_t& list = agobjects();
+            bool stale = m_agrid.size() != list.size();
+            for(auto it = list.cbegin(); !stale && it != list.cend(); ++it) {
+                stale = !m_agrid.contains(*it);
+            }
+            if( stale ) {
+                m_agrid.clear();
+                for(const ageom_ref_t& g : list) {
+                    m_agrid.insert(g);
+                }
+            } else {
+                m_agrid.update_all();
+            }
+        }
+
         bool tick(const float dt){
             for (auto it = m_pengs_all.begin(); it != m_pengs_all.end();) {
                 physiks::ball_ref_t& p = *it;
@@ -178,6 +199,7 @@ class canon_t {
             point_t bl = korb_box.bl;
             korb_box.tr.add(-basket_frame_thickness, 0);
             korb_box.bl.add( basket_frame_thickness, basket_frame_thickness);
+            update_agrid();
             for (auto it = m_pengs_flying.begin(); it != m_pengs_flying.end();) {
                 physiks::ball_ref_t& p = *it;
                 if(p->box().intersects( korb_box )){
@@ -188,7 +210,9 @@ class canon_t {
                     // rotate_adeg(rot_step * dt * pixel::next_rnd() * 3.0f);
                 } else {
                     ++it;
-                    for(geom_ref_t g : agobjects()){
+                    m_agrid_res.clear();
+                    m_agrid.query(m_agrid_res, p->box());
+                    for(geom_ref_t g : m_agrid_res){
                         if(g->intersects(p->box()) && g != p){
                             ++m_cp;
                         }
@@ -359,6 +383,7 @@ void mainloop() {
 int main(int argc, char *argv[])
 {
     int window_width = 1920, window_height = 1000;
+    unsigned int tiled_threads = 0;
     float adeg=0, velocity=1;
     bool auto_shoot = false;
     #if defined(__EMSCRIPTEN__)
@@ -377,6 +402,9 @@ int main(int argc, char *argv[])
             } else if( 0 == strcmp("-fps", argv[i]) && i+1<argc) {
                 pixel::set_gpu_forced_fps(atoi(argv[i+1]));
                 ++i;
+            } else if( 0 == strcmp("-tiled", argv[i]) && i+1<argc) {
+                tiled_threads = static_cast<unsigned int>( std::max(0, atoi(argv[i+1])) );
+                ++i;
             } else if( 0 == strcmp("-adeg", argv[i]) && i+1<argc) {
                 adeg = static_cast<float>( std::atof(argv[i+1]) );
                 ++i;
@@ -395,17 +423,20 @@ int main(int argc, char *argv[])
         }
     }
     {
-        log_printf(0, "Usage %s -1p -width <int> -height <int> "
+        log_printf(0, "Usage %s -1p -width <int> -height <int> -tiled <threads> "
                                       " -debug_gfx -show_velo\n", argv[0]);
         log_printf(0, "- win size %d x %d\n", window_width, window_height);
         log_printf(0, "- forced_fps %d\n", pixel::gpu_forced_fps());
+        log_printf(0, "- tiled threads %u\n", tiled_threads);
         log_printf(0, "- debug_gfx %d\n", debug_gfx);
     }
     {
         const float origin_norm[] = { 0.5f, 0.5f };
-        if( !pixel::init_gfx_subsystem(argv[0], "canonball", window_width, window_height, origin_norm) ) {
+        // software primitives are required for the tiled rasterizer
+        if( !pixel::init_gfx_subsystem(argv[0], "canonball", window_width, window_height, origin_norm, true, 0 == tiled_threads) ) {
             return 1;
         }
+        pixel::set_fb_tiled(tiled_threads);
     }
     pixel::cart_coord.set_height(-space_height/2.0f, space_height/2.0f);
     player.resize();
@@ -340,13 +340,18 @@ static uint64_t t_start = 0; // [ms]
 static bool load_samples() {
     audio_samples.clear();
     if( jau::audio::is_audio_subsystem_initialized() ) {
-        audio_samples.push_back( std::make_shared<jau::audio::audio_sample_t>("pacman/intro.ogg") );
-        audio_samples.push_back( std::make_shared<jau::audio::audio_sample_t>("pacman/munch.wav") );
-        audio_samples.push_back( std::make_shared<jau::audio::audio_sample_t>("pacman/eatfruit.ogg") );
-        audio_samples.push_back( std::make_shared<jau::audio::audio_sample_t>("pacman/eatghost.ogg", false /* single_play */) );
-        audio_samples.push_back( std::make_shared<jau::audio::audio_sample_t>("pacman/death.ogg") );
-        // audio_samples.push_back( std::make_shared<audio_sample_t>("pacman/extrapac.ogg") );
-        // audio_samples.push_back( std::make_shared<audio_sample_t>("pacman/intermission.ogg") );
+        // decode in parallel on the asset loader workers
+        std::vector<jau::audio::audio_sample_future> futures;
+        futures.push_back( jau::audio::load_sample_async("pacman/intro.ogg", true) );
+        futures.push_back( jau::audio::load_sample_async("pacman/munch.wav", true) );
+        futures.push_back( jau::audio::load_sample_async("pacman/eatfruit.ogg", true) );
+        futures.push_back( jau::audio::load_sample_async("pacman/eatghost.ogg", false /* single_play */) );
+        futures.push_back( jau::audio::load_sample_async("pacman/death.ogg", true) );
+        // futures.push_back( jau::audio::load_sample_async("pacman/extrapac.ogg", true) );
+        // futures.push_back( jau::audio::load_sample_async("pacman/intermission.ogg", true) );
+        for(const jau::audio::audio_sample_future& f : futures) {
+            audio_samples.push_back( f.get() );
+        }
         return true;
     } else {
         for(int i=0; i <= number( audio_clip_t::DEATH ); ++i) {
@@ -887,6 +892,7 @@ int main(int argc, char *argv[])
     for(const ghost_ref& g : ghosts()) {
         jau::log_printf("%s\n", g->toString().c_str());
     }
+    jau::log_printf("%s\n", pixel::asset_path_stats().toString().c_str());
 
     current_level = start_level - 1;
     pacman->reset_score();
@@ -26,6 +26,7 @@
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "game.hpp"
 #include <jau/utils.hpp>
 
@@ -598,17 +599,24 @@ bool maze_t::digest_ibox_line(const std::string& name, box_t& dest, const std::s
 maze_t::maze_t(const std::string& fname0) noexcept
 : filename(fname0)
 {
-    const std::string fname1 = pixel::resolve_asset(fname0);
+    const pixel::asset_data_t packed = pixel::find_archived_asset(fname0);
+    const std::string fname1 = packed.valid() ? fname0 : pixel::resolve_asset(fname0);
     if( !fname1.size() ) {
         jau::log_printf("maze_t: Could locate file '%s' in asset dir '%s'\n", fname0.c_str(), pixel::asset_dir().c_str());
         return;
     }
     int field_line_iter = 0;
+    std::istringstream packed_in;
     std::fstream file;
-    file.open(fname1, std::ios::in);
-    if( file.is_open() ) {
+    if( packed.valid() ) {
+        packed_in.str(std::string(reinterpret_cast<const char*>(packed.data), packed.size));
+    } else {
+        file.open(fname1, std::ios::in);
+    }
+    std::istream& in = packed.valid() ? static_cast<std::istream&>(packed_in) : file;
+    if( packed.valid() || file.is_open() ) {
         std::string line;
-        while( std::getline(file, line) ) {
+        while( std::getline(in, line) ) {
             if( 0 == original.width() || 0 == original.height() ) {
                 int w=-1, h=-1;
                 int visual_width=-1, visual_height=-1;
@@ -688,15 +696,7 @@ maze_t::maze_t(const std::string& fname0) noexcept
 }
 
 void maze_t::draw(const std::function<void(const float x, const float y, tile_t tile)>& draw_pixel) noexcept {
-    for(int y=0; y<height(); ++y) {
-        for(int x=0; x<width(); ++x) {
-            if( fruit_pos_.intersects_i(x, y) ) {
-                draw_pixel(fruit_pos_.x_f(), fruit_pos_.y_f(), active.tile_nc(x, y));
-            } else {
-                draw_pixel((float)x, (float)y, active.tile_nc(x, y));
-            }
-        }
-    }
+    draw<const std::function<void(const float x, const float y, tile_t tile)>&>(draw_pixel);
 }
 
 void maze_t::reset() noexcept {
@@ -430,6 +430,24 @@ class maze_t {
         tile_t tile(const int x, const int y) const noexcept { return active.tile(x, y); }
         void set_tile(const int x, const int y, tile_t tile) noexcept { active.set_tile(x, y, tile); }
 
+        /**
+         * Visits all tiles with the given visitor `void(const float x_pos, const float y_pos, tile_t tile)`,
+         * passing the fruit tile at its fractional position.
+         *
+         * Templated visitor allowing the per-tile call to be inlined, see the std::function variant.
+         */
+        template<typename Visitor>
+        void draw(Visitor&& draw_pixel) noexcept {
+            for(int y=0; y<height(); ++y) {
+                for(int x=0; x<width(); ++x) {
+                    if( fruit_pos_.intersects_i(x, y) ) {
+                        draw_pixel(fruit_pos_.x_f(), fruit_pos_.y_f(), active.tile_nc(x, y));
+                    } else {
+                        draw_pixel((float)x, (float)y, active.tile_nc(x, y));
+                    }
+                }
+            }
+        }
         void draw(const std::function<void(const float x_pos, const float y_pos, tile_t tile)>& draw_pixel) noexcept;
 
         void reset() noexcept;
@@ -210,7 +210,7 @@ pixel::texture_ref draw_text(const std::string& text, uint8_t r, uint8_t g, uint
 
 {
     pixel::set_pixel_color(r, g, b, 255);
-    pixel::texture_ref ttex = pixel::make_text(text);
+    pixel::texture_ref ttex = pixel::make_text_cached(0, text);
     if( nullptr != ttex ) {
         float x_pos=0, y_pos=0;
         set_coord(*ttex, x_pos, y_pos, pixel::cart_coord.from_fb_dx(ttex->width)-3, pixel::cart_coord.from_fb_dy(ttex->height)-2); // FIXME: text-dim adjustment
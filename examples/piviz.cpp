@@ -52,43 +52,26 @@ void draw_circle_seg(const point_t& pm, float r, const float thickness, float co
         if( 1 >= thickness ) {
             p0.draw();
         } else {
-            //const float t = thickness*2.0f/3.0f;
-            rect_t(p0, thickness, thickness, true).draw(true);
+            pixel::fill_disk_fbcoord(pixel::cart_coord.to_fb_x(p0.x), pixel::cart_coord.to_fb_y(p0.y),
+                                     pixel::cart_coord.to_fb_dx(thickness / 2));
         }
     }
 }
 
 void draw_circle(const point_t& pm, float r, float thickness, circle_t e){
-    float y;
-    float x;
-    float r1 = r + thickness / 2;
-    for(y = r + thickness; y >= -r - thickness; --y){
-        for(x = -r - thickness; x <= r + thickness; ++x) {
-            float l = sqrt(x*x + y*y);
-            switch(e){
-            case circle_t::line:
-                if(l >= r && l <= r + thickness){
-                    point_t p(x, y);
-                    p += pm;
-                    p.draw();
-                }
-                break;
-            case circle_t::filled:
-                if(l <= r1){
-                    point_t p(x, y);
-                    p += pm;
-                    p.draw();
-                }
-                break;
-            case circle_t::aabbox:
-                if(l > r1){
-                    point_t p(x, y);
-                    p += pm;
-                    p.draw();
-                }
-                break;
-            }
-        }
+    const int cx = pixel::cart_coord.to_fb_x(pm.x);
+    const int cy = pixel::cart_coord.to_fb_y(pm.y);
+    const float r1 = r + thickness / 2;
+    switch(e){
+    case circle_t::line:
+        pixel::draw_ring_fbcoord(cx, cy, pixel::cart_coord.to_fb_dx(r + thickness), pixel::cart_coord.to_fb_dx(r));
+        break;
+    case circle_t::filled:
+        pixel::fill_disk_fbcoord(cx, cy, pixel::cart_coord.to_fb_dx(r1));
+        break;
+    case circle_t::aabbox:
+        pixel::fill_disk_inverted_fbcoord(cx, cy, pixel::cart_coord.to_fb_dx(r1), pixel::cart_coord.to_fb_dx(r + thickness));
+        break;
     }
 }
 
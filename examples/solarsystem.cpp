@@ -735,6 +735,7 @@ void mainloop() {
 int main(int argc, char *argv[])
 {
     int window_width = 1920, window_height = 1000;
+    unsigned int tiled_threads = 0;
     #if defined(__EMSCRIPTEN__)
         window_width = 1024, window_height = 576; // 16:9
     #endif
@@ -750,6 +751,9 @@ int main(int argc, char *argv[])
             } else if( 0 == strcmp("-fps", argv[i]) && i+1<argc) {
                 pixel::set_gpu_forced_fps(atoi(argv[i+1]));
                 ++i;
+            } else if( 0 == strcmp("-tiled", argv[i]) && i+1<argc) {
+                tiled_threads = static_cast<unsigned int>( std::max(0, atoi(argv[i+1])) );
+                ++i;
             } else if( 0 == strcmp("-color_inv", argv[i]) ) {
                 set_colorinv(true);
             } else if( 0 == strcmp("-record", argv[i]) && i+1<argc) {
@@ -783,6 +787,7 @@ int main(int argc, char *argv[])
     {
         log_printf(0, "- win size %d x %d\n", window_width, window_height);
         log_printf(0, "- forced_fps %d\n", pixel::gpu_forced_fps());
+        log_printf(0, "- tiled threads %u\n", tiled_threads);
         log_printf(0, "- data_stop %d\n", ref_cbody_stop);
         log_printf(0, "- gravity formula %d\n", gravity_formula);
         log_printf(0, "- show_velo %d\n", show_cbody_velo);
@@ -790,9 +795,11 @@ int main(int argc, char *argv[])
     }
     {
         const float origin_norm[] = { 0.5f, 0.5f };
-        if( !pixel::init_gfx_subsystem(argv[0], "solarsystem", window_width, window_height, origin_norm) ) {
+        // software primitives are required for the tiled rasterizer
+        if( !pixel::init_gfx_subsystem(argv[0], "solarsystem", window_width, window_height, origin_norm, true, 0 == tiled_threads) ) {
             return 1;
         }
+        pixel::set_fb_tiled(tiled_threads);
     }
     // space_height = n.sfplts + n.pluto_radius; // [km]
     // space_height = n.sfnets; //  + n.neptun_radius; // [km]
@@ -178,14 +178,23 @@ static audio_sample_ref audio_saucer, audio_peng, audio_alienX, audio_baseX;
 static bool load_samples() {
     audio_aliens.clear();
     if( jau::audio::is_audio_subsystem_initialized() ) {
-        audio_aliens.push_back( std::make_shared<jau::audio::audio_sample_t>("spaceinv/alien1.wav", false, MIX_MAX_VOLUME) );
-        audio_aliens.push_back( std::make_shared<jau::audio::audio_sample_t>("spaceinv/alien2.wav", false, MIX_MAX_VOLUME) );
-        audio_aliens.push_back( std::make_shared<jau::audio::audio_sample_t>("spaceinv/alien3.wav", false, MIX_MAX_VOLUME) );
-        audio_aliens.push_back( std::make_shared<jau::audio::audio_sample_t>("spaceinv/alien4.wav", false, MIX_MAX_VOLUME) );
-        audio_saucer = std::make_shared<jau::audio::audio_sample_t>("spaceinv/alienM.ogg", false, MIX_MAX_VOLUME/4);
-        audio_peng = std::make_shared<jau::audio::audio_sample_t>("spaceinv/peng.wav", false, MIX_MAX_VOLUME/4);
-        audio_alienX = std::make_shared<jau::audio::audio_sample_t>("spaceinv/alienX.wav", false, MIX_MAX_VOLUME/4);
-        audio_baseX = std::make_shared<jau::audio::audio_sample_t>("spaceinv/baseX.wav", false, MIX_MAX_VOLUME);
+        // decode in parallel on the asset loader workers
+        std::vector<audio_sample_future> aliens;
+        aliens.push_back( load_sample_async("spaceinv/alien1.wav", false, MIX_MAX_VOLUME) );
+        aliens.push_back( load_sample_async("spaceinv/alien2.wav", false, MIX_MAX_VOLUME) );
+        aliens.push_back( load_sample_async("spaceinv/alien3.wav", false, MIX_MAX_VOLUME) );
+        aliens.push_back( load_sample_async("spaceinv/alien4.wav", false, MIX_MAX_VOLUME) );
+        audio_sample_future saucer = load_sample_async("spaceinv/alienM.ogg", false, MIX_MAX_VOLUME/4);
+        audio_sample_future peng = load_sample_async("spaceinv/peng.wav", false, MIX_MAX_VOLUME/4);
+        audio_sample_future alienX = load_sample_async("spaceinv/alienX.wav", false, MIX_MAX_VOLUME/4);
+        audio_sample_future baseX = load_sample_async("spaceinv/baseX.wav", false, MIX_MAX_VOLUME);
+        for(const audio_sample_future& f : aliens) {
+            audio_aliens.push_back( f.get() );
+        }
+        audio_saucer = saucer.get();
+        audio_peng = peng.get();
+        audio_alienX = alienX.get();
+        audio_baseX = baseX.get();
         return true;
     } else {
         audio_aliens.push_back( std::make_shared<jau::audio::audio_sample_t>() );
@@ -202,11 +211,13 @@ static bool load_textures() {
         pixel::bitmap_ref empty = std::make_shared<pixel::bitmap_t>(64, 64);
         log_printf(0, "XX empty: %s\n", empty->toString().c_str());
     }
-    bmp_bunk = std::make_shared<pixel::bitmap_t>("spaceinv/spaceinv-bunk.png");
+    pixel::bitmap_future bunk_f = pixel::load_bitmap_async("spaceinv/spaceinv-bunk.png");
+    pixel::texture_future all_images_f = pixel::load_texture_async("spaceinv/spaceinv-sprites.png");
+    bmp_bunk = bunk_f.get();
     log_printf(0, "XX bmp bunk: %s\n", bmp_bunk->toString().c_str());
 
     int y_off=0;
-    all_images = std::make_shared<pixel::texture_t>("spaceinv/spaceinv-sprites.png");
+    all_images = pixel::await_texture(all_images_f);
     if( !all_images->handle() ) {
         return false;
     }
@@ -1324,6 +1335,10 @@ int main(int argc, char *argv[])
         }
     #endif
     load_samples();
+    for(const pixel::asset_timing_t& t : pixel::asset_load_timings()) {
+        log_printf(0, "XX asset %s\n", t.toString().c_str());
+    }
+    log_printf(0, "XX %s\n", pixel::asset_path_stats().toString().c_str());
     reset_items();
     #if defined(__EMSCRIPTEN__)
         (void)use_audio;
@@ -26,6 +26,7 @@
 
 #include <unistd.h>
 #include <string>
+#include <vector>
 
 #include <cmath>
 #include <cstdarg>
@@ -73,6 +74,14 @@ namespace jau::fs {
     /** Returns true if path exists _and_ is accessible. */
     bool exists(const std::string& path) noexcept;
 
+    /**
+     * Appends the paths of all regular files within given directory and its sub-directories to `files`,
+     * relative to `dir` using `/` separators and skipping hidden entries.
+     * Symbolic links are followed, each directory is listed once to stop at symbolic link cycles.
+     * @return false if `dir` could not be opened
+     */
+    bool list_files(const std::string& dir, std::vector<std::string>& files) noexcept;
+
     std::string lookup_asset_dir(const char* exe_path, const char* asset_file, const char* asset_install_subdir) noexcept;
 }
 
@@ -0,0 +1,121 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef PIXEL_ASSET_ARCHIVE_HPP_
+#define PIXEL_ASSET_ARCHIVE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Packed asset archive file format, written by the gfxbox2_pack tool and memory-mapped via pixel::open_asset_archive().
+ *
+ * Layout in host byte order, i.e. little-endian on all supported targets:
+ * - header_t
+ * - entry_t index of header_t::count entries sorted by entry_t::hash, then name
+ * - asset names, not terminated
+ * - asset data, each aligned to data_alignment
+ *
+ * Asset names are paths relative to the asset directory using '/' separators, e.g. `pacman/tiles_all.png`.
+ */
+namespace pixel::archive {
+    /** File magic of an asset archive */
+    inline constexpr char magic[8] = { 'G', 'F', 'X', 'P', 'A', 'K', '\0', '\0' };
+    inline constexpr uint32_t version = 1;
+    /** Alignment of each asset's data within the archive */
+    inline constexpr uint64_t data_alignment = 16;
+    /** Default archive file name within the asset directory */
+    inline constexpr const char* default_name = "gfxbox2.pak";
+
+    /** Asset data format, derived from the file name extension */
+    enum class format_t : uint32_t {
+        unknown = 0, png, bmp, wav, ogg, ttf, txt
+    };
+
+    constexpr const char* to_string(const format_t f) noexcept {
+        switch( f ) {
+            case format_t::png: return "png";
+            case format_t::bmp: return "bmp";
+            case format_t::wav: return "wav";
+            case format_t::ogg: return "ogg";
+            case format_t::ttf: return "ttf";
+            case format_t::txt: return "txt";
+            default:            return "unknown";
+        }
+    }
+
+    constexpr format_t format_of(const std::string_view name) noexcept {
+        const size_t dot = name.rfind('.');
+        if( std::string_view::npos == dot ) {
+            return format_t::unknown;
+        }
+        const std::string_view ext = name.substr(dot + 1);
+        for(format_t f : { format_t::png, format_t::bmp, format_t::wav, format_t::ogg, format_t::ttf, format_t::txt }) {
+            if( ext == to_string(f) ) {
+                return f;
+            }
+        }
+        return format_t::unknown;
+    }
+
+    /** 64-bit FNV-1a hash of the asset name */
+    constexpr uint64_t hash(const std::string_view name) noexcept {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for(const char c : name) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    struct header_t {
+        char magic[8];
+        uint32_t version;
+        /** number of entries */
+        uint32_t count;
+        /** file offset of the entry_t index */
+        uint64_t index_offset;
+        /** file offset of the asset names */
+        uint64_t names_offset;
+    };
+    static_assert(32 == sizeof(header_t));
+
+    struct entry_t {
+        /** hash() of the asset name */
+        uint64_t hash;
+        /** file offset of the asset data */
+        uint64_t offset;
+        /** asset data length in bytes */
+        uint64_t length;
+        /** asset name offset relative to header_t::names_offset */
+        uint32_t name_offset;
+        /** asset name length */
+        uint32_t name_length;
+        format_t format;
+        uint32_t reserved;
+    };
+    static_assert(40 == sizeof(entry_t));
+}
+
+#endif /* PIXEL_ASSET_ARCHIVE_HPP_ */
@@ -24,6 +24,7 @@
 #ifndef JAU_AUDIO_HPP_
 #define JAU_AUDIO_HPP_
 
+#include <future>
 #include <memory>
 #include <string>
 
@@ -106,6 +107,17 @@ namespace jau::audio {
             bool is_valid() const { return nullptr != chunk.get(); }
     };
     typedef std::shared_ptr<audio_sample_t> audio_sample_ref;
+    typedef std::shared_future<audio_sample_ref> audio_sample_future;
+
+    /**
+     * Decodes the given sample on the asset loader workers, see pixel::asset_loader_submit().
+     *
+     * The future resolves to an invalid sample on error, see audio_sample_t::is_valid().
+     * @param fname
+     * @param single_play see audio_sample_t::set_single_play()
+     * @param volume value from 0 to MIX_MAX_VOLUME
+     */
+    audio_sample_future load_sample_async(const std::string &fname, const bool single_play, const int volume=MIX_MAX_VOLUME/2);
 
 }
 
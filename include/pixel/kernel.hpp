@@ -0,0 +1,80 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef PIXEL_KERNEL_HPP_
+#define PIXEL_KERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 32-bit pixel kernels for the software framebuffer and bitmaps,
+ * runtime dispatched to AVX2 or SSE2 if supported, otherwise using a scalar implementation.
+ */
+namespace pixel::kernel {
+
+    enum class isa_t : uint8_t {
+        scalar,
+        sse2,
+        avx2
+    };
+    /** Returns the instruction set used by the kernels, detected at first use. */
+    isa_t isa() noexcept;
+    const char* to_string(isa_t v) noexcept;
+    /** Returns true if the given instruction set is supported by this CPU and build. */
+    bool supported(isa_t v) noexcept;
+    /**
+     * Forces the kernels to use the given instruction set, e.g. for benchmarks,
+     * returns false and keeps the current one if not supported().
+     *
+     * Not thread-safe, must not be called while kernels are in use.
+     */
+    bool set_isa(isa_t v) noexcept;
+
+    /** Sets count pixel at dst to value. */
+    void fill(uint32_t* dst, size_t count, uint32_t value) noexcept;
+
+    /** Sets the width x height rectangle at dst with row stride in pixels to value. */
+    void fill_rect(uint32_t* dst, size_t stride, size_t width, size_t height, uint32_t value) noexcept;
+
+    /**
+     * Blends the ARGB8888 color src over count ARGB8888 pixel at dst,
+     * i.e. `dst = src * a + dst * (1 - a)` per channel using the alpha a of src.
+     */
+    void blend(uint32_t* dst, size_t count, uint32_t src) noexcept;
+
+    /**
+     * Blends count ARGB8888 pixel at src over count ARGB8888 pixel at dst,
+     * i.e. `dst = src * a + dst * (1 - a)` per channel using the alpha a of each src pixel.
+     */
+    void blend_over(uint32_t* dst, const uint32_t* src, size_t count) noexcept;
+
+    /** Returns true if all count pixel at src are equal to value. */
+    bool equals(const uint32_t* src, size_t count, uint32_t value) noexcept;
+
+    /** Returns true if all pixel of the width x height rectangle at src with row stride in pixels are equal to value. */
+    bool equals_rect(const uint32_t* src, size_t stride, size_t width, size_t height, uint32_t value) noexcept;
+
+}
+
+#endif /*  PIXEL_KERNEL_HPP_ */
@@ -24,10 +24,14 @@
 #ifndef PIXEL_HPP_
 #define PIXEL_HPP_
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <functional> // NOLINT(unused-includes): Used in other header
+#include <future>
 #include <string>
 #include <vector>
+#include <utility>
 
 #include <cmath>
 #include <cstdarg>
@@ -41,6 +45,7 @@
 #include <jau/fraction_type.hpp>
 #include <jau/utils.hpp>
 #include <pixel/version.hpp>
+#include <pixel/kernel.hpp>
 
 #if defined(__EMSCRIPTEN__)
     #include <emscripten.h>
@@ -64,10 +69,73 @@ namespace pixel::f4 {
  */
 namespace pixel {
 
-    std::string lookup_and_register_asset_dir(const char* exe_path, const char* asset_file="fonts/freefont/FreeSansBold.ttf", const char* asset_install_subdir="gfxbox2") noexcept;
+    /**
+     * Looks up and registers the asset directory containing asset_file, see jau::fs::lookup_asset_dir().
+     *
+     * Clears the resolved asset path cache of resolve_asset().
+     * If prescan is true, all files within the asset directory are cached upfront
+     * and resolve_asset() answers them w/o filesystem access, other files are probed once.
+     */
+    std::string lookup_and_register_asset_dir(const char* exe_path, const char* asset_file="fonts/freefont/FreeSansBold.ttf", const char* asset_install_subdir="gfxbox2",
+                                              bool prescan=false) noexcept;
     std::string asset_dir() noexcept;
+    /**
+     * Returns the absolute path of given asset_file within the asset directory,
+     * given asset_file itself if lookup_direct and existing, otherwise an empty string.
+     *
+     * Results are cached process-wide including negative lookups, thread safe.
+     */
     std::string resolve_asset(const std::string &asset_file, bool lookup_direct=false) noexcept;
 
+    /** Asset path resolution statistics, see asset_path_stats() */
+    struct asset_path_stats_t {
+        /** resolve_asset() calls */
+        uint64_t lookups = 0;
+        /** resolve_asset() calls answered from the cache */
+        uint64_t cached = 0;
+        /** filesystem probes of resolve_asset() */
+        uint64_t probes = 0;
+        /** files cached by the asset directory pre-scan */
+        uint64_t prescanned = 0;
+        /** duration of the asset directory lookup in microseconds */
+        uint64_t dir_lookup_us = 0;
+        /** duration of the asset directory pre-scan in microseconds */
+        uint64_t prescan_us = 0;
+        /** accumulated duration of resolve_asset() in microseconds */
+        uint64_t resolve_us = 0;
+
+        std::string toString() const noexcept;
+    };
+    /** Returns the asset path resolution statistics since lookup_and_register_asset_dir() */
+    asset_path_stats_t asset_path_stats() noexcept;
+
+    /** Read-only view of an asset within the opened asset archive, see find_archived_asset() */
+    struct asset_data_t {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+        constexpr bool valid() const noexcept { return nullptr != data; }
+    };
+
+    /**
+     * Memory-maps the given asset archive written by the gfxbox2_pack tool, see pixel/asset_archive.hpp.
+     *
+     * Opened by init_gfx_subsystem() from environment variable `GFXBOX2_ASSET_ARCHIVE`
+     * or `gfxbox2.pak` within the asset directory, if existing.
+     * Asset loaders look up the archive first, falling back to files within the asset directory.
+     * @return true if the archive is valid and mapped
+     */
+    bool open_asset_archive(const std::string& fname) noexcept;
+    /** Unmaps the asset archive, all assets decoded from the archive shall be released before. */
+    void close_asset_archive() noexcept;
+    /** Returns the file name of the opened asset archive or an empty string */
+    std::string asset_archive() noexcept;
+    /**
+     * Returns the data of the given asset file relative to the asset directory within the opened asset archive,
+     * or an invalid asset_data_t if not archived. The data stays mapped until close_asset_archive().
+     */
+    asset_data_t find_archived_asset(const std::string& asset_file) noexcept;
+
     /** Width of the window, coordinate in window units. */
     extern int win_width;
     /** Height of the window, coordinate in window units. */
@@ -84,8 +152,110 @@ namespace pixel {
     extern int fb_max_x;
     /** y-axis maximum of the framebuffer coordinate in pixels. */
     extern int fb_max_y;
-    typedef std::vector<uint32_t> pixel_buffer_t; // 32-bit pixel
+    /** Allocator aligning storage to Alignment bytes, e.g. to match SIMD register width. */
+    template<typename T, size_t Alignment>
+    struct aligned_allocator_t {
+        typedef T value_type;
+        template<typename U> struct rebind { typedef aligned_allocator_t<U, Alignment> other; };
+
+        aligned_allocator_t() noexcept = default;
+        template<typename U> aligned_allocator_t(const aligned_allocator_t<U, Alignment>&) noexcept {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>( ::operator new(n * sizeof(T), std::align_val_t(Alignment)) );
+        }
+        void deallocate(T* p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+        template<typename U> bool operator==(const aligned_allocator_t<U, Alignment>&) const noexcept { return true; }
+    };
+    typedef std::vector<uint32_t, aligned_allocator_t<uint32_t, 64>> pixel_buffer_t; // 32-bit pixel, 64-byte aligned
     extern pixel_buffer_t fb_pixels;
+
+    /** Axis aligned box of framebuffer pixels [x1..x2] x [y1..y2], empty if x1 > x2. */
+    struct fb_region_t {
+        int x1 = std::numeric_limits<int>::max();
+        int y1 = std::numeric_limits<int>::max();
+        int x2 = std::numeric_limits<int>::min();
+        int y2 = std::numeric_limits<int>::min();
+
+        constexpr bool empty() const noexcept { return x1 > x2; }
+        constexpr int width() const noexcept { return empty() ? 0 : x2 - x1 + 1; }
+        constexpr int height() const noexcept { return empty() ? 0 : y2 - y1 + 1; }
+
+        void clear() noexcept { *this = fb_region_t(); }
+        void set_all() noexcept { x1 = 0; y1 = 0; x2 = fb_max_x; y2 = fb_max_y; }
+        /** Extends this region by given pixel, which must be within the framebuffer. */
+        void add(const int x, const int y) noexcept {
+            x1 = std::min(x1, x); y1 = std::min(y1, y);
+            x2 = std::max(x2, x); y2 = std::max(y2, y);
+        }
+        /** Extends this region by given box, which must be within the framebuffer. */
+        void add(const int x1_, const int y1_, const int x2_, const int y2_) noexcept {
+            x1 = std::min(x1, x1_); y1 = std::min(y1, y1_);
+            x2 = std::max(x2, x2_); y2 = std::max(y2, y2_);
+        }
+        void add(const fb_region_t& o) noexcept {
+            if( !o.empty() ) {
+                add(o.x1, o.y1, o.x2, o.y2);
+            }
+        }
+        std::string toString() const noexcept {
+            return "fb_region[" + std::to_string(x1) + "/" + std::to_string(y1) + " .. " + std::to_string(x2) + "/" + std::to_string(y2) + "]";
+        }
+    };
+    /**
+     * Software framebuffer pixels of the current frame with a row stride of fb_stride pixels.
+     *
+     * Points to fb_pixels, or to the locked streaming texture memory
+     * between fb_begin_frame() and swap_pixel_fb() if set_fb_streaming() is enabled.
+     */
+    extern uint32_t* fb_data;
+    /** Row stride of fb_data in pixels, >= fb_width. */
+    extern int fb_stride;
+
+    /**
+     * Dirty region of fb_pixels, i.e. the union of all software writes since the last swap_pixel_fb() or clear_pixel_fb().
+     *
+     * Only the dirty region and the area refilled by clear_pixel_fb() is uploaded at swap_pixel_fb(), see fb_last_upload().
+     * User code writing into fb_pixels directly must add the written box.
+     */
+    extern fb_region_t fb_dirty;
+
+    /**
+     * Returns the region of fb_pixels uploaded to the texture by the last swap_pixel_fb(), empty if none.
+     *
+     * Besides fb_dirty, it includes the area refilled by clear_pixel_fb(),
+     * i.e. the software writes since the previous clear if cleared with the same color.
+     */
+    fb_region_t fb_last_upload() noexcept;
+
+    /**
+     * Enable the tile-binned software rasterizer using given number of threads including the caller, 0 disables (default).
+     *
+     * If enabled, software triangles, quads, disks, rings and lines are recorded and binned into 64x64 pixel tiles,
+     * which are rasterized in parallel at fb_tiles_flush(), each tile by one thread in submission order.
+     * The result is identical to the immediate software rasterizer.
+     */
+    void set_fb_tiled(unsigned int threads) noexcept;
+    /** Returns the number of tiled rasterizer threads, 0 if disabled, see set_fb_tiled(). */
+    unsigned int fb_tiled() noexcept;
+    /** True if recorded tiled rasterizer commands are pending, see fb_tiles_flush(). */
+    extern bool fb_tiles_pending;
+    /**
+     * Rasterizes all recorded tiled rasterizer commands into fb_data.
+     *
+     * Implicitly called by all other software writes, swap_pixel_fb() and fb_begin_frame().
+     * User code accessing fb_data directly must call it first.
+     */
+    void fb_tiles_flush() noexcept;
+    /** Records a triangle for the tiled rasterizer, see fill_triangle_fbcoord(). */
+    void fb_tiles_add_triangle(int x1, int y1, int x2, int y2, int x3, int y3) noexcept;
+    /** Records disk spans for the tiled rasterizer, the disk r_out (or square if box is true) excluding the disk r_excl. */
+    void fb_tiles_add_disk(int cx, int cy, int r_out, int r_excl, bool box) noexcept;
+    /** Records a line for the tiled rasterizer, see draw_line_fbcoord(). */
+    void fb_tiles_add_line(int x1, int y1, int x2, int y2) noexcept;
+
     extern int font_height;
 
     enum class orientation_t {
@@ -352,6 +522,46 @@ namespace pixel {
     void subsys_draw_line(int thickness, int x1, int y1, int x2, int y2) noexcept;
     void subsys_draw_box(bool filled, int x, int y, int width, int height) noexcept;
 
+    /** Horizontal span of pixels [x1..x2] on row y in framebuffer coordinates. */
+    struct fb_span_t {
+        int x1;
+        int x2;
+        int y;
+    };
+    /** Draws all given horizontal spans with one subsys call. */
+    void subsys_draw_spans(const fb_span_t* spans, size_t count) noexcept;
+    /** Vertex in framebuffer coordinates, pixel centers are located at +0.5. */
+    struct fb_vertex_t {
+        float x;
+        float y;
+    };
+    /** Fills the given triangle list, i.e. count / 3 triangles, using the current draw color with one subsys call. */
+    void subsys_fill_triangles(const fb_vertex_t* vertices, size_t count) noexcept;
+
+    /** Statistics of the subsys primitive command buffer for one frame. */
+    struct subsys_batch_stats_t {
+        /** Number of recorded subsys primitive and color calls */
+        size_t recorded = 0;
+        /** Number of SDL render calls submitted for the recorded calls */
+        size_t submitted = 0;
+
+        std::string toString() const noexcept {
+            return "batch[recorded "+std::to_string(recorded)+", submitted "+std::to_string(submitted)+"]";
+        }
+    };
+    /**
+     * Submits all pending subsys primitives and sprites.
+     *
+     * Subsys primitives are recorded in a per-frame command buffer, grouped by color and primitive type.
+     * The buffer is flushed at a color change, swap_pixel_fb(), swap_gpu_buffer()
+     * and before any other render operation, hence the draw order between colors is preserved.
+     *
+     * Likewise consecutive sprites of the same texture are batched, see draw_sprite_fbcoord().
+     */
+    void subsys_flush() noexcept;
+    /** Returns the subsys command buffer statistics of the last swapped frame. */
+    subsys_batch_stats_t subsys_batch_stats() noexcept;
+
     //
     // Pixel color
     //
@@ -373,10 +583,125 @@ namespace pixel {
         if( use_subsys_primitives_val ) {
             subsys_draw_pixel(x, y);
         } else if( 0 <= x && x <= fb_max_x && 0 <= y && y <= fb_max_y ) {
-            fb_pixels[ y * fb_width + x ] = draw_color;
+            if( fb_tiles_pending ) {
+                fb_tiles_flush();
+            }
+            fb_data[ y * fb_stride + x ] = draw_color;
+            fb_dirty.add(x, y);
+        }
+    }
+
+    /**
+     * Draw a horizontal span of pixels [x1..x2] on row y using the given draw_color and given fb coordinates.
+     *
+     * The span is clipped against the framebuffer, i.e. out of bounds pixel are discarded.
+     */
+    inline void draw_span_fbcoord(int x1, int x2, int y) noexcept {
+        if( x1 > x2 ) {
+            std::swap(x1, x2);
+        }
+        if( use_subsys_primitives_val ) {
+            subsys_draw_line(x1, y, x2, y);
+        } else if( 0 <= y && y <= fb_max_y && x1 <= fb_max_x && 0 <= x2 ) {
+            x1 = std::max(0, x1);
+            x2 = std::min(fb_max_x, x2);
+            if( fb_tiles_pending ) {
+                fb_tiles_flush();
+            }
+            kernel::fill(fb_data + ( y * fb_stride + x1 ), size_t(x2 - x1 + 1), draw_color);
+            fb_dirty.add(x1, y, x2, y);
+        }
+    }
+
+    /**
+     * Blend the given draw_color including its alpha over a horizontal span of pixels [x1..x2] on row y in fb coordinates.
+     *
+     * The span is clipped against the framebuffer. Using subsys primitives, the span is drawn as a line with the current subsys blend mode.
+     */
+    inline void blend_span_fbcoord(int x1, int x2, int y) noexcept {
+        if( x1 > x2 ) {
+            std::swap(x1, x2);
+        }
+        if( use_subsys_primitives_val ) {
+            subsys_draw_line(x1, y, x2, y);
+        } else if( 0 <= y && y <= fb_max_y && x1 <= fb_max_x && 0 <= x2 ) {
+            x1 = std::max(0, x1);
+            x2 = std::min(fb_max_x, x2);
+            if( fb_tiles_pending ) {
+                fb_tiles_flush();
+            }
+            kernel::blend(fb_data + ( y * fb_stride + x1 ), size_t(x2 - x1 + 1), draw_color);
+            fb_dirty.add(x1, y, x2, y);
         }
     }
 
+    /**
+     * Draw a line using the given draw_color and given fb coordinates.
+     *
+     * Using software primitives, the line is clipped against the framebuffer first
+     * and only its visible pixels are stepped via integer Bresenham,
+     * covering exactly the pixels of the unclipped line within the framebuffer.
+     */
+    void draw_line_fbcoord(int x1, int y1, int x2, int y2) noexcept;
+
+    /**
+     * Draw an anti-aliased line using the given draw_color and given fb coordinates via Xiaolin Wu's algorithm.
+     *
+     * Using software primitives, pixel coverage is blended into the framebuffer,
+     * otherwise draw_line_fbcoord() is used.
+     */
+    void draw_line_aa_fbcoord(float x1, float y1, float x2, float y2) noexcept;
+
+    /**
+     * Draw the given horizontal spans using the given draw_color and given fb coordinates.
+     *
+     * Using subsys primitives, all spans are submitted at once.
+     * Out of bounds pixel are discarded.
+     */
+    void draw_spans_fbcoord(const fb_span_t* spans, size_t count) noexcept;
+
+    /**
+     * Fill a triangle using the given draw_color and given fb coordinates.
+     *
+     * The triangle is rasterized into one horizontal span per row,
+     * including pixels on its edges and clipped against the framebuffer.
+     */
+    void fill_triangle_fbcoord(int x1, int y1, int x2, int y2, int x3, int y3) noexcept;
+
+    /**
+     * Fill a convex quadrilateral with its vertices given in winding order
+     * using the given draw_color and given fb coordinates.
+     *
+     * Using subsys primitives, the quad is submitted as two triangles at once.
+     */
+    void fill_quad_fbcoord(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4) noexcept;
+
+    /**
+     * Fill a disk of given radius using the given draw_color and given fb coordinates.
+     *
+     * The disk is rasterized via integer midpoint stepping into horizontal spans,
+     * covering all pixel with a center distance of less than r + 1/2.
+     *
+     * Using subsys primitives, the disk is submitted as one tessellated triangle fan instead.
+     */
+    void fill_disk_fbcoord(int cx, int cy, int r) noexcept;
+
+    /**
+     * Draw a ring using the given draw_color and given fb coordinates,
+     * i.e. all pixel of the disk with radius r_outer but not within the disk of radius r_inner - 1.
+     *
+     * Using r_outer == r_inner draws a one pixel wide circle outline.
+     *
+     * Using subsys primitives, rings wider than one pixel are submitted as one tessellated triangle strip.
+     */
+    void draw_ring_fbcoord(int cx, int cy, int r_outer, int r_inner) noexcept;
+
+    /**
+     * Fill the square around the given center with half width r_box
+     * using the given draw_color and given fb coordinates, excluding the disk of radius r.
+     */
+    void fill_disk_inverted_fbcoord(int cx, int cy, int r, int r_box) noexcept;
+
     /**
      * Set a pixel using the given draw_color and given cartesian coordinates.
      *
@@ -507,6 +832,7 @@ namespace pixel {
 
             constexpr void* handle() noexcept { return m_handle; }
             constexpr uint8_t* pixels() noexcept { return m_pixels; }
+            constexpr const uint8_t* pixels() const noexcept { return m_pixels; }
 
             void set_pixel(int x, int y, uint32_t abgr) noexcept;
 
@@ -534,6 +860,13 @@ namespace pixel {
             /** Test if given box equals given abgr value */
             bool equals(const f2::aabbox_t& box, uint32_t abgr) noexcept;
 
+            /**
+             * Replaces all pixels of abgr value palette[i].first by palette[i].second, i.e. a palette swap
+             * deriving a recolored sprite set from one bitmap, see clone().
+             * @return number of replaced pixels
+             */
+            size_t swap_palette(const std::vector<std::pair<uint32_t, uint32_t>>& palette) noexcept;
+
             std::string toString() const noexcept {
                 return (m_handle ? " (set) " : " (empty) ") +
                        std::to_string(width)+"x"+std::to_string(height)+"x"+std::to_string(bpp)+
@@ -542,10 +875,112 @@ namespace pixel {
     };
     typedef std::shared_ptr<bitmap_t> bitmap_ref;
 
+    //
+    // Software sprite blitter
+    //
+
+    /** Pixel selection of blit_fbcoord() and rle_sprite_t */
+    enum class blit_mode_t : uint8_t {
+        /** copy all pixels */
+        copy,
+        /** copy all pixels except those equal to the color key */
+        color_key,
+        /** blend pixels over the framebuffer using their alpha, skipping fully transparent pixels */
+        alpha
+    };
+
+    /**
+     * Blits the given ABGR8888 bitmap into fb_pixels with its top-left corner at fb_x/fb_y,
+     * each pixel scaled to a scale x scale block and clipped against the framebuffer.
+     *
+     * Writes fb_pixels independent of use_subsys_primitives(), visible with the next swap_pixel_fb().
+     * @param color_key ABGR8888 value of transparent pixels for blit_mode_t::color_key
+     */
+    void blit_fbcoord(const bitmap_t& bmp, int fb_x, int fb_y, int scale=1, blit_mode_t mode=blit_mode_t::alpha, uint32_t color_key=0) noexcept;
+
+    /**
+     * Sprite preprocessed into run-length encoded spans of visible pixels per row in fb_pixels format,
+     * blitted via blit_fbcoord() skipping transparent pixels for free.
+     *
+     * Opaque spans are copied, translucent spans are blended.
+     */
+    class rle_sprite_t {
+        public:
+            struct span_t {
+                /** span start column */
+                uint16_t x;
+                /** span length in pixels */
+                uint16_t len;
+                /** true if all pixels are opaque */
+                bool opaque;
+                /** index of the first span pixel within pixels */
+                uint32_t offset;
+            };
+            uint32_t width = 0;
+            uint32_t height = 0;
+            /** spans ordered by row */
+            std::vector<span_t> spans;
+            /** index of the first span of each row within spans, height + 1 entries */
+            std::vector<uint32_t> rows;
+            /** ARGB8888 pixels of all spans */
+            std::vector<uint32_t> pixels;
+
+            rle_sprite_t() noexcept = default;
+
+            /**
+             * Encodes the visible pixels of given ABGR8888 bitmap.
+             * @param color_key ABGR8888 value of transparent pixels for blit_mode_t::color_key
+             */
+            rle_sprite_t(const bitmap_t& bmp, blit_mode_t mode=blit_mode_t::alpha, uint32_t color_key=0) noexcept;
+
+            /** Returns the encoded size in bytes */
+            size_t byte_size() const noexcept {
+                return spans.size() * sizeof(span_t) + rows.size() * sizeof(uint32_t) + pixels.size() * sizeof(uint32_t);
+            }
+
+            std::string toString() const noexcept;
+    };
+    typedef std::shared_ptr<rle_sprite_t> rle_sprite_ref;
+
+    /** Blits the given sprite into fb_pixels like blit_fbcoord(const bitmap_t&, ...). */
+    void blit_fbcoord(const rle_sprite_t& sprite, int fb_x, int fb_y, int scale=1) noexcept;
+
     //
     // Texture
     //
 
+    /** Blend mode of texture_t draw calls */
+    enum class blend_mode_t : uint8_t {
+        /** keep the texture's own blend mode */
+        native,
+        /** no blending, copy */
+        none,
+        /** alpha blending */
+        blend,
+        /** additive blending */
+        add,
+        /** color modulation */
+        mod,
+        /** color multiplication */
+        mul
+    };
+
+    /** Glyph quad of a text texture, see make_text(). */
+    struct text_glyph_t {
+        /** glyph pos-x within the glyph atlas */
+        uint16_t src_x;
+        /** glyph pos-y within the glyph atlas */
+        uint16_t src_y;
+        /** glyph width */
+        uint16_t width;
+        /** glyph height */
+        uint16_t height;
+        /** glyph pos-x within the text texture */
+        int32_t x;
+        /** glyph pos-y within the text texture */
+        int32_t y;
+    };
+
     class texture_t {
         private:
             void* m_handle;
@@ -576,6 +1011,21 @@ namespace pixel {
             float dest_sx;
             /** dest texture scale-y */
             float dest_sy;
+            /**
+             * Atlas kept alive by this texture, i.e. the page of a tex_atlas_t sub-texture
+             * or the glyph atlas of a text texture without own handle, drawn as textured quads, see make_text().
+             */
+            std::shared_ptr<texture_t> atlas;
+            /** glyph quads of a text texture within atlas */
+            std::vector<text_glyph_t> text_glyphs;
+            /** text color of a text texture */
+            uint32_t text_color = 0;
+            /** color modulation of draw calls, multiplied with the texture colors, default white */
+            uint8_t mod_r = 255, mod_g = 255, mod_b = 255;
+            /** alpha modulation of draw calls, multiplied with the texture alpha, default opaque */
+            uint8_t mod_a = 255;
+            /** blend mode of draw calls, changing the blend mode breaks the sprite batch */
+            blend_mode_t blend_mode = blend_mode_t::native;
 
             texture_t(void* handle_, const uint32_t x_, const uint32_t y_, const uint32_t width_, const uint32_t height_, const uint32_t bpp_, const uint32_t format_, const bool owner=true) noexcept
             : m_handle(handle_), m_owner(nullptr!=handle_ && owner),
@@ -591,13 +1041,26 @@ namespace pixel {
             texture_t(const texture_t& parent, int /*unused*/) noexcept
             : m_handle(parent.m_handle), m_owner(false),
               x(parent.x), y(parent.y), width(parent.width), height(parent.height), bpp(parent.bpp), format(parent.format),
-              dest_x(0), dest_y(0), dest_sx(1), dest_sy(1) {}
+              dest_x(0), dest_y(0), dest_sx(1), dest_sy(1),
+              atlas(parent.atlas), text_glyphs(parent.text_glyphs), text_color(parent.text_color),
+              mod_r(parent.mod_r), mod_g(parent.mod_g), mod_b(parent.mod_b), mod_a(parent.mod_a), blend_mode(parent.blend_mode) {}
 
             /** Create a shared proxy clone w/o ownership */
             std::shared_ptr<texture_t> createShared() {
                 return std::make_shared<texture_t>(*this, 0);
             }
 
+            /**
+             * Create a shared proxy clone w/o ownership drawn with given color and alpha modulation and blend mode,
+             * i.e. a recolored sprite sharing this texture's pixels.
+             */
+            std::shared_ptr<texture_t> createTinted(uint8_t r, uint8_t g, uint8_t b, uint8_t a=255, blend_mode_t blend=blend_mode_t::native) {
+                std::shared_ptr<texture_t> res = createShared();
+                res->set_mod(r, g, b, a);
+                res->blend_mode = blend;
+                return res;
+            }
+
             texture_t() noexcept
             : m_handle(nullptr), m_owner(false), x(0), y(0), width(0), height(0), bpp(0), format(0), dest_x(0), dest_y(0), dest_sx(1), dest_sy(1) {}
 
@@ -617,10 +1080,15 @@ namespace pixel {
             void disown() noexcept { m_owner = false; }
             void set_owner(bool v) noexcept { m_owner = v; }
 
+            /** Sets color and alpha modulation of draw calls */
+            void set_mod(uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) noexcept {
+                mod_r = r; mod_g = g; mod_b = b; mod_a = a;
+            }
+
             /** update texture */
             void update(const bitmap_ref& bmap) noexcept;
 
-            /// draw using top-left FB coordinates and dimension, 0/0 is top-left
+            /// draw using top-left FB coordinates and dimension, 0/0 is top-left, modulated by mod_r, mod_g, mod_b and mod_a using blend_mode
             void draw_raw(const uint32_t fb_x, const uint32_t fb_y, const uint32_t fb_w, const uint32_t fb_h) const noexcept;
             /// draw using top-left FB coordinates and optional scale, 0/0 is top-left
             void draw_fbcoord(const uint32_t x_pos, const uint32_t y_pos, const float scale_x=1.0f, const float scale_y=1.0f) const noexcept {
@@ -643,13 +1111,25 @@ namespace pixel {
             }
 
             std::string toString() const noexcept {
-                return (m_handle ? " (set) " : " (empty) ") +
+                return (m_handle ? " (set) " : ( atlas ? " (text) " : " (empty) " ) ) +
                        std::to_string(x)+"/"+std::to_string(y) + " " + std::to_string(width)+"x"+std::to_string(height)+"x"+std::to_string(bpp) +
                        ", " + format_str(format) + ", owner " + std::to_string(m_owner);
             }
     };
     typedef std::shared_ptr<texture_t> texture_ref;
 
+    /**
+     * Draw given texture as a sprite quad using top-left FB coordinates and dimension,
+     * rotated by angle_deg clockwise around its center and modulated by given color
+     * as well as the texture's color and alpha modulation using its blend_mode.
+     *
+     * Consecutive sprites of the same texture are batched and submitted with one SDL_RenderGeometry call,
+     * a texture change or any other render operation flushes the batch, see subsys_flush().
+     * All texture_t and animtex_t draw methods use the sprite batch, hence sprites of one texture or tex_atlas_t page are batched.
+     */
+    void draw_sprite_fbcoord(const texture_t& tex, float fb_x, float fb_y, float fb_w, float fb_h, float angle_deg=0.0f,
+                             uint8_t r=255, uint8_t g=255, uint8_t b=255, uint8_t a=255) noexcept;
+
     struct tex_sub_coord_t {
         int x;
         int y;
@@ -698,6 +1178,80 @@ namespace pixel {
      */
     texture_ref add_sub_texture(const texture_ref& parent, uint32_t x_off, uint32_t y_off, uint32_t w, uint32_t h) noexcept;
 
+    /**
+     * Handle of a bitmap packed into a tex_atlas_t, i.e. its page index and rectangle within that page.
+     *
+     * A plain value valid until its atlas is cleared or destroyed, an empty rectangle denotes an invalid handle.
+     */
+    struct tex_atlas_sub_t {
+        /** page index within the atlas */
+        uint32_t page;
+        int x;
+        int y;
+        int width;
+        int height;
+
+        constexpr bool valid() const noexcept { return 0 < width && 0 < height; }
+    };
+
+    /**
+     * Texture atlas packing bitmaps into few large page textures at load time using a skyline bottom-left packer.
+     *
+     * Each packed bitmap is uploaded into its page once and returned as a tex_atlas_sub_t handle.
+     * Hence sprites of different animtex_t instances share few textures and can be batched.
+     */
+    class tex_atlas_t {
+        private:
+            /** Skyline segment [x, x+width) at height y */
+            struct skyline_t {
+                uint32_t x;
+                uint32_t y;
+                uint32_t width;
+            };
+            struct page_t {
+                texture_ref tex;
+                std::vector<skyline_t> skyline;
+            };
+            uint32_t m_page_width;
+            uint32_t m_page_height;
+            std::vector<page_t> m_pages;
+
+            bool add_page(uint32_t width, uint32_t height) noexcept;
+            static bool pack(page_t& page, uint32_t w, uint32_t h, uint32_t& x, uint32_t& y) noexcept;
+
+        public:
+            /** Create an empty atlas with given page size, larger bitmaps get their own page */
+            tex_atlas_t(uint32_t page_width=1024, uint32_t page_height=1024) noexcept
+            : m_page_width(page_width), m_page_height(page_height) {}
+
+            /** Packs given bitmap into the atlas, returns its handle or an invalid handle on error. */
+            tex_atlas_sub_t add(const bitmap_ref& bmap) noexcept;
+
+            /** Loads given image file and packs it into the atlas, see add(). */
+            tex_atlas_sub_t add(const std::string& fname) noexcept;
+
+            /**
+             * Returns a non-owning sub-texture of given handle keeping its page alive, or nullptr if invalid.
+             *
+             * Compatibility conversion for texture_ref users, draw_fbcoord() draws the handle directly.
+             */
+            texture_ref texture(const tex_atlas_sub_t& sub) const noexcept;
+
+            /** Draws given handle as a sprite quad using top-left FB coordinates and dimension, see draw_sprite_fbcoord(). */
+            void draw_fbcoord(const tex_atlas_sub_t& sub, float fb_x, float fb_y, float fb_w, float fb_h, float angle_deg=0.0f) const noexcept;
+
+            /** Returns the number of page textures */
+            size_t page_count() const noexcept { return m_pages.size(); }
+
+            /** Drops all pages from the atlas, invalidating all handles. Sub-textures of texture() keep their page alive. */
+            void clear() noexcept { m_pages.clear(); }
+
+            std::string toString() const noexcept;
+    };
+
+    /** Returns the default texture atlas, e.g. used by animtex_t for its frames */
+    tex_atlas_t& default_tex_atlas() noexcept;
+
     class animtex_t {
         private:
             std::string m_name;
@@ -706,11 +1260,17 @@ namespace pixel {
             float m_atex_sec_left;
             bool m_paused;
             size_t m_animation_index;
+            /** atlas of m_subs if the frames are packed into it, otherwise nullptr */
+            const tex_atlas_t* m_atlas;
 
         public:
+            /** frames of a sprite-sheet or texture list animation */
             std::vector<texture_ref> m_textures;
+            /** frames packed into m_atlas, see animtex_t(name, sec_per_atex, filenames) */
+            std::vector<tex_atlas_sub_t> m_subs;
             animtex_t(std::string name, float sec_per_atex, const std::vector<texture_ref>& textures) noexcept;
 
+            /** Create an animation of given image files, packed into default_tex_atlas() */
             animtex_t(std::string name, float sec_per_atex, const std::vector<const char*>& filenames) noexcept;
 
             animtex_t(std::string name, float sec_per_atex, const std::string& filename, int w, int h, int x_off) noexcept;
@@ -728,13 +1288,32 @@ namespace pixel {
                 clear();
             }
             size_t& anim_idx() { return m_animation_index; }
-            void clear() noexcept { m_textures.clear(); m_sec_per_atex=0; m_atex_sec_left=0; m_animation_index=0; m_paused=true; }
+            void clear() noexcept { m_textures.clear(); m_subs.clear(); m_atlas=nullptr; m_sec_per_atex=0; m_atex_sec_left=0; m_animation_index=0; m_paused=true; }
 
-            const texture_ref texture(const size_t idx) const noexcept { return idx < m_textures.size() ? m_textures[idx] : nullptr; }
-            const texture_ref texture() const noexcept { return m_animation_index < m_textures.size() ? m_textures[m_animation_index] : nullptr; }
+            /** Returns the number of frames */
+            size_t size() const noexcept { return nullptr != m_atlas ? m_subs.size() : m_textures.size(); }
 
-            uint32_t width() noexcept { texture_ref tex = texture(); return nullptr!=tex ? tex->width : 0; }
-            uint32_t height() noexcept { texture_ref tex = texture(); return nullptr!=tex ? tex->height : 0; }
+            /** Returns given frame as texture_ref, converting a packed frame via tex_atlas_t::texture() */
+            const texture_ref texture(const size_t idx) const noexcept {
+                if( nullptr != m_atlas ) {
+                    return idx < m_subs.size() ? m_atlas->texture(m_subs[idx]) : nullptr;
+                }
+                return idx < m_textures.size() ? m_textures[idx] : nullptr;
+            }
+            const texture_ref texture() const noexcept { return texture(m_animation_index); }
+
+            uint32_t width() noexcept {
+                if( nullptr != m_atlas ) {
+                    return m_animation_index < m_subs.size() ? uint32_t(m_subs[m_animation_index].width) : 0;
+                }
+                texture_ref tex = texture(); return nullptr!=tex ? tex->width : 0;
+            }
+            uint32_t height() noexcept {
+                if( nullptr != m_atlas ) {
+                    return m_animation_index < m_subs.size() ? uint32_t(m_subs[m_animation_index].height) : 0;
+                }
+                texture_ref tex = texture(); return nullptr!=tex ? tex->height : 0;
+            }
 
             void reset() noexcept;
             void pause(bool enable) noexcept;
@@ -743,6 +1322,13 @@ namespace pixel {
 
             /// draw using top-left cartesian coordinates and dimension
             void draw(const float x_pos, const float y_pos, const float w, const float h) const noexcept {
+                if( nullptr != m_atlas ) {
+                    if( m_animation_index < m_subs.size() ) {
+                        m_atlas->draw_fbcoord(m_subs[m_animation_index], (float)pixel::cart_coord.to_fb_x( x_pos ), (float)pixel::cart_coord.to_fb_y( y_pos ),
+                                              (float)pixel::cart_coord.to_fb_dy(w), (float)pixel::cart_coord.to_fb_dy(h));
+                    }
+                    return;
+                }
                 texture_ref tex = texture();
                 if( nullptr != tex ) {
                     tex->draw(x_pos, y_pos, w, h);
@@ -750,6 +1336,14 @@ namespace pixel {
             }
             /// draw using top-left cartesian coordinates, converting texture-dimension to FB values
             void draw(const float x_pos, const float y_pos) const noexcept {
+                if( nullptr != m_atlas ) {
+                    if( m_animation_index < m_subs.size() ) {
+                        const tex_atlas_sub_t& sub = m_subs[m_animation_index];
+                        m_atlas->draw_fbcoord(sub, (float)pixel::cart_coord.to_fb_x( x_pos ), (float)pixel::cart_coord.to_fb_y( y_pos ),
+                                              (float)pixel::cart_coord.to_fb_dy(float(sub.width)), (float)pixel::cart_coord.to_fb_dy(float(sub.height)));
+                    }
+                    return;
+                }
                 texture_ref tex = texture();
                 if( nullptr != tex ) {
                     tex->draw(x_pos, y_pos);
@@ -759,6 +1353,73 @@ namespace pixel {
             std::string toString() const noexcept;
     };
 
+    //
+    // Asset Loader
+    //
+
+    typedef std::shared_future<bitmap_ref> bitmap_future;
+    typedef std::shared_future<texture_ref> texture_future;
+
+    /** Load timing of one asset, see asset_load_timings() */
+    struct asset_timing_t {
+        /** asset file name */
+        std::string name;
+        /** decoding duration in microseconds */
+        uint64_t decode_us;
+        /** duration from request until ready in microseconds, including queueing and texture creation */
+        uint64_t total_us;
+
+        std::string toString() const noexcept;
+    };
+
+    /**
+     * Sets the number of asset loader worker threads, 0 decodes synchronously within the requesting thread.
+     *
+     * Defaults to the hardware concurrency limited to 4 threads, or 0 on emscripten.
+     * Running workers are stopped, pending jobs are run within the calling thread to resolve their futures.
+     */
+    void set_asset_loader_threads(unsigned threads) noexcept;
+    /** Returns the number of asset loader worker threads, see set_asset_loader_threads() */
+    unsigned asset_loader_threads() noexcept;
+
+    /**
+     * Submits the given decoding job of the named asset to the asset loader workers and records its load timing.
+     *
+     * The job must not use the renderer, e.g. may decode a bitmap_t or audio sample.
+     */
+    void asset_loader_submit(const std::string& name, std::function<void()> job) noexcept;
+
+    /**
+     * Decodes the given image file into a bitmap_t on the asset loader workers.
+     *
+     * The future resolves to an empty bitmap_t on error, see bitmap_t(const std::string&).
+     */
+    bitmap_future load_bitmap_async(const std::string& fname) noexcept;
+
+    /**
+     * Decodes the given image file on the asset loader workers and creates its texture_t on the render thread.
+     *
+     * The texture is created by process_asset_uploads(), hence the render thread shall wait via await_texture().
+     * The future resolves to a texture_t w/o handle on error, see texture_t(const std::string&).
+     */
+    texture_future load_texture_async(const std::string& fname) noexcept;
+
+    /**
+     * Creates the textures of decoded assets, must be called on the render thread.
+     *
+     * Called by swap_gpu_buffer() and await_texture().
+     * @return number of created textures
+     */
+    size_t process_asset_uploads() noexcept;
+
+    /** Waits until the given texture is ready while processing asset uploads, must be called on the render thread. */
+    texture_ref await_texture(const texture_future& f) noexcept;
+
+    /** Returns the load timings of all assets loaded via the asset loader so far */
+    std::vector<asset_timing_t> asset_load_timings() noexcept;
+    /** Clears the recorded asset load timings */
+    void clear_asset_load_timings() noexcept;
+
     //
     // gfx toolkit dependent API
     //
@@ -775,6 +1436,30 @@ namespace pixel {
     /** Optional forced frames per seconds, pass to swap_gpu_buffer() by default. */
     void set_gpu_forced_fps(int fps) noexcept;
 
+    /**
+     * Enable skipping the upload and present of unchanged frames, disabled by default.
+     *
+     * Using software primitives, a frame is unchanged if nothing is uploaded, i.e. fb_dirty and the clear_pixel_fb() refill are empty,
+     * and no other render operation besides clear_pixel_fb() has been issued since the last swap_gpu_buffer().
+     */
+    void set_skip_unchanged_frames(bool v) noexcept;
+    /** Returns true if unchanged frames are skipped, see set_skip_unchanged_frames(). */
+    bool skip_unchanged_frames() noexcept;
+
+    /**
+     * Enable rendering software primitives directly into a locked streaming texture, disabled by default.
+     *
+     * If enabled, fb_data points to the locked texture memory between fb_begin_frame() and swap_pixel_fb(),
+     * saving the extra copy of fb_pixels. The locked memory is undefined at fb_begin_frame(),
+     * hence each frame must be fully redrawn, e.g. starting with clear_pixel_fb().
+     * Writes into fb_pixels while not locked are uploaded as usual.
+     */
+    void set_fb_streaming(bool v) noexcept;
+    /** Returns true if streaming framebuffer mode is enabled, see set_fb_streaming(). */
+    bool fb_streaming() noexcept;
+    /** Locks the streaming framebuffer texture into fb_data if enabled, implicitly called by clear_pixel_fb(). */
+    void fb_begin_frame() noexcept;
+
     /** Returns expected fps, either gpu_forced_fps() if set, otherwise monitor_fps(). */
     inline int expected_fps() noexcept { int v=gpu_forced_fps(); return v>0?v:monitor_fps(); }
     /** Returns the expected frame duration in [s], i.e. 1/expected_fps() */
@@ -783,9 +1468,17 @@ namespace pixel {
     }
 
     bool is_gfx_subsystem_initialized() noexcept;
-    /** GFX Toolkit: Initialize a window of given size with a usable framebuffer. */
+    /**
+     * GFX Toolkit: Initialize a window of given size with a usable framebuffer.
+     *
+     * If headless is true or the environment variable GFXBOX2_HEADLESS is set to a non-zero value,
+     * no window is created and all rendering happens offscreen into an SDL software surface of given size.
+     * Textures, make_text() and save_snapshot() remain functional, while swap_gpu_buffer() runs unthrottled.
+     */
     bool init_gfx_subsystem(const char* exe_path, const char* title, int window_width, int window_height, const float origin_norm[2],
-                            bool enable_vsync=true, bool use_subsys_primitives=true);
+                            bool enable_vsync=true, bool use_subsys_primitives=true, bool headless=false);
+    /** Returns true if the gfx subsystem has been initialized headless, see init_gfx_subsystem(). */
+    bool is_gfx_headless() noexcept;
     /** GFX Toolkit: Clear the soft-framebuffer. */
     void clear_pixel_fb(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept;
     /** GFX Toolkit: Copy the soft-framebuffer to the GPU back-buffer, if swap_buffer is true (default) also swap_gpu_buffer(). */
@@ -797,8 +1490,21 @@ namespace pixel {
     /** Returns the measured gpu frame duration in [s] each 5s, starting with 1/gpu_avg_fps() */
     jau::fraction_timespec gpu_avg_framedur() noexcept;
 
+    /**
+     * Returns a text texture of given Latin-1 text using the current draw_color and the default font of size font_height.
+     *
+     * The text is laid out as glyph quads of a glyph atlas, built once per font size,
+     * and drawn as one batch of textured quads without rasterizing the text or uploading a texture.
+     */
     texture_ref make_text(const std::string& text) noexcept;
 
+    /**
+     * Returns a text texture of given Latin-1 text using the current draw_color, rendered at its native pixel size font_size.
+     *
+     * Fonts are cached per size and opened lazily from the font file read once into memory.
+     */
+    texture_ref make_text(const int font_size, const std::string& text) noexcept;
+
     texture_ref make_text(const char* format, ...) noexcept;
 
 
@@ -816,6 +1522,49 @@ namespace pixel {
         return make_text(tl, lineno, color, font_height, text);
     }
 
+    /** Text label cache statistics, see make_text_cached(). */
+    struct text_cache_stats_t {
+        /** number of lookups returning a cached texture */
+        size_t hits;
+        /** number of lookups creating a new texture */
+        size_t misses;
+        /** number of evicted entries */
+        size_t evictions;
+        /** number of cached entries */
+        size_t entries;
+        /** estimated bytes of all cached entries */
+        size_t bytes;
+
+        std::string toString() const noexcept;
+    };
+
+    /**
+     * Returns the cached text texture of given id, e.g. a unique number per call site, text,
+     * current draw_color and font size, otherwise creates and caches a new one via make_text().
+     *
+     * Entries are evicted least recently used first when exceeding text_cache_budget().
+     */
+    texture_ref make_text_cached(uint64_t id, const std::string& text) noexcept;
+
+    /** Returns a cached text texture placed like make_text(tl, lineno, color, font_height_usr, text), see make_text_cached(). */
+    texture_ref make_text_cached(uint64_t id, const pixel::f2::point_t& tl, const int lineno,
+                                 const pixel::f4::vec_t& color, const int font_height_usr,
+                                 const std::string& text) noexcept;
+
+    /** Returns a cached text texture placed like make_text(tl, lineno, color, font_height_usr, format, ...), see make_text_cached(). */
+    texture_ref make_text_cached(uint64_t id, const pixel::f2::point_t& tl, const int lineno,
+                                 const pixel::f4::vec_t& color, const int font_height_usr,
+                                 const char* format, ...) noexcept;
+
+    /** Set the estimated memory budget of the text label cache in bytes, defaults to 1 MiB. Zero disables caching. */
+    void set_text_cache_budget(size_t bytes) noexcept;
+    /** Returns the memory budget of the text label cache in bytes, see set_text_cache_budget(). */
+    size_t text_cache_budget() noexcept;
+    /** Returns the text label cache statistics. */
+    text_cache_stats_t text_cache_stats() noexcept;
+    /** Drops all cached text textures, retaining the statistics. */
+    void clear_text_cache() noexcept;
+
     //
     // input
     //
@@ -25,6 +25,7 @@
 #define PIXEL2F_HPP_
 
 #include <string>
+#include <unordered_map>
 #include "pixel.hpp"
 
 /**
@@ -346,6 +347,18 @@ namespace pixel::f2 {
     class aabbox_t; // fwd
     class lineseg_t; // fwd
 
+    /** Shape kind of a geom_t, selecting the exact narrow-phase intersection test. */
+    enum class shape_t : uint8_t {
+        /** Unknown shape, tested via its own intersects(const aabbox_t&) */
+        other,
+        aabbox,
+        lineseg,
+        triangle,
+        rect,
+        disk,
+        linestrip
+    };
+
     /**
      * Geometric object
      */
@@ -353,6 +366,9 @@ namespace pixel::f2 {
     public:
         virtual ~geom_t() = default;
 
+        /** Returns the shape kind, defaults to shape_t::other. */
+        virtual shape_t shape() const noexcept { return shape_t::other; }
+
         virtual aabbox_t box() const noexcept = 0;
         virtual bool contains(const point_t& o) const noexcept = 0;
         virtual bool intersects(const lineseg_t & o) const noexcept = 0;
@@ -375,6 +391,16 @@ namespace pixel::f2 {
     typedef std::shared_ptr<geom_t> geom_ref_t;
     typedef std::vector<geom_ref_t> geom_list_t;
 
+    /**
+     * Exact narrow-phase intersection test of both objects, dispatched by their shape_t pair.
+     *
+     * Convex shapes (aabbox_t, lineseg_t, triangle_t and rotated rect_t) use the separating axis theorem (SAT),
+     * disk_t is tested by distance against their edges and linestrip_t per segment,
+     * including containment if closed, i.e. first and last point are equal.
+     * Shapes of shape_t::other are tested via their own intersects() against the other's box.
+     */
+    bool intersects(const geom_t& a, const geom_t& b) noexcept;
+
     geom_list_t& gobjects();
 
     /**
@@ -490,6 +516,8 @@ namespace pixel::f2 {
             return resize(p.x, p.y);
         }
 
+        shape_t shape() const noexcept override { return shape_t::aabbox; }
+
         constexpr aabbox_t box() const noexcept override { return *this; }
 
         constexpr float width() const noexcept { return tr.x - bl.x; }
@@ -539,7 +567,7 @@ namespace pixel::f2 {
 #endif
 
         bool intersects(const geom_t& o) const noexcept override {
-            return intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         /// Returns intersecting aabbox, maybe of width() and height() zero if not intersecting
@@ -652,8 +680,14 @@ namespace pixel::f2 {
             return p0.on_screen() && p1.on_screen();
         }
 
-        static void for_all_points(const point_t& p0, const point_t& p1,
-                const point_action_t& point_action) noexcept
+        /**
+         * Visits all rasterized points from p0 to p1 with the given visitor `bool(const point_t& p)`,
+         * stopping if it returns false.
+         *
+         * Templated visitor allowing the call to be inlined, see the point_action_t variant.
+         */
+        template<typename Visitor>
+        static void for_all_points(const point_t& p0, const point_t& p1, Visitor&& point_action) noexcept
         {
             const float dx = p1.x - p0.x;
             const float dy = p1.y - p0.y;
@@ -685,6 +719,17 @@ namespace pixel::f2 {
                 }
             }
         }
+
+        static void for_all_points(const point_t& p0, const point_t& p1, const point_action_t& point_action) noexcept {
+            for_all_points<const point_action_t&>(p0, p1, point_action);
+        }
+
+        /** Appends all rasterized points from p0 to p1 to `res`, returns the number of appended points. */
+        static size_t points(std::vector<point_t>& res, const point_t& p0, const point_t& p1) noexcept {
+            const size_t n = res.size();
+            for_all_points(p0, p1, [&res](const point_t& p) -> bool { res.push_back(p); return true; });
+            return res.size() - n;
+        }
         static void draw(const point_t& p0, const point_t& p1) noexcept;
 
         void draw() const noexcept override {
@@ -694,6 +739,8 @@ namespace pixel::f2 {
         /**
          * Create an AABBox with given lineseg
          */
+        shape_t shape() const noexcept override { return shape_t::lineseg; }
+
         aabbox_t box() const noexcept override {
             return aabbox_t().resize(p0).resize(p1);
         }
@@ -930,7 +977,7 @@ namespace pixel::f2 {
         }
 
         bool intersects(const geom_t& o) const noexcept override {
-            return intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         bool intersection(vec_t& reflect_out, vec_t& cross_normal, point_t& cross_point, const lineseg_t& in) const noexcept override {
@@ -956,7 +1003,7 @@ namespace pixel::f2 {
      * </pre>
      * </p>
      */
-    class ray_t /** TODO : public geom_t **/ {
+    class ray_t : public geom_t {
     public:
         /** Origin of Ray. */
         point_t orig;
@@ -964,7 +1011,143 @@ namespace pixel::f2 {
         /** Normalized direction vector of ray. */
         vec_t dir;
 
-        std::string toString() const noexcept { return "Ray[orig "+orig.toString()+", dir "+dir.toString() +"]"; }
+        constexpr ray_t() noexcept
+        : orig(), dir() {}
+
+        /** Create a ray with given origin and direction, the latter will be normalized. */
+        constexpr ray_t(const point_t& orig_, const vec_t& dir_) noexcept
+        : orig(orig_), dir(dir_) { dir.normalize(); }
+
+        /** Returns the point R(t) = R0 + Rd * t */
+        constexpr point_t at(const float t) const noexcept { return orig + dir * t; }
+
+        /**
+         * Returns the unbound box, i.e. extending to +/- float max along the direction's signs.
+         */
+        aabbox_t box() const noexcept override {
+            constexpr float m = std::numeric_limits<float>::max();
+            return aabbox_t(point_t(dir.x < 0 ? -m : orig.x, dir.y < 0 ? -m : orig.y),
+                            point_t(dir.x > 0 ?  m : orig.x, dir.y > 0 ?  m : orig.y));
+        }
+
+        bool contains(const point_t& p) const noexcept override {
+            const vec_t v = p - orig;
+            return jau::is_zero( v.cross(dir) ) && v.dot(dir) >= 0;
+        }
+
+        /**
+         * Slab test of this ray against the given box.
+         * @param t_near storage for the ray distance entering the box, zero if orig is inside, otherwise unchanged
+         * @param box the aabbox_t to test
+         * @return true if the ray hits the box, otherwise false
+         */
+        bool intersects(float& t_near, const aabbox_t& box) const noexcept {
+            float t_far;
+            return intersects(t_near, t_far, box);
+        }
+
+        /**
+         * Slab test of this ray against the given box.
+         * @param t_near storage for the ray distance entering the box, zero if orig is inside, otherwise unchanged
+         * @param t_far storage for the ray distance leaving the box, otherwise unchanged
+         * @param box the aabbox_t to test
+         * @return true if the ray hits the box, otherwise false
+         */
+        bool intersects(float& t_near, float& t_far, const aabbox_t& box) const noexcept {
+            float t0 = 0, t1 = std::numeric_limits<float>::max();
+            const float o[] = { orig.x, orig.y };
+            const float d[] = { dir.x, dir.y };
+            const float lo[] = { box.bl.x, box.bl.y };
+            const float hi[] = { box.tr.x, box.tr.y };
+            for(int i=0; i<2; ++i) {
+                if( jau::is_zero(d[i]) ) {
+                    // parallel to slab, must start within
+                    if( o[i] < lo[i] || o[i] > hi[i] ) {
+                        return false;
+                    }
+                    continue;
+                }
+                const float inv = 1.0f / d[i];
+                float tn = ( lo[i] - o[i] ) * inv;
+                float tf = ( hi[i] - o[i] ) * inv;
+                if( tn > tf ) {
+                    std::swap(tn, tf);
+                }
+                t0 = std::max(t0, tn);
+                t1 = std::min(t1, tf);
+                if( t0 > t1 ) {
+                    return false;
+                }
+            }
+            t_near = t0;
+            t_far = t1;
+            return true;
+        }
+
+        /**
+         * Compute intersection of this ray with the given line segment.
+         * @param t storage for the ray distance at the intersection, otherwise unchanged
+         * @param l the line segment
+         * @return true if intersecting, otherwise false. Collinear overlap is not considered an intersection.
+         */
+        bool intersects(float& t, const lineseg_t& l) const noexcept {
+            const vec_t s = l.p1 - l.p0;
+            const float rxs = dir.cross(s);
+            if( jau::is_zero(rxs) ) {
+                return false;
+            }
+            const vec_t q_p = l.p0 - orig;
+            const float t_ = q_p.cross(s) / rxs;
+            const float u = q_p.cross(dir) / rxs;
+            if( t_ < 0 || u < 0 || u > 1 ) {
+                return false;
+            }
+            t = t_;
+            return true;
+        }
+
+        bool intersects(const lineseg_t& l) const noexcept override {
+            float t;
+            return intersects(t, l);
+        }
+
+        bool intersects(const aabbox_t& box) const noexcept override {
+            float t;
+            return intersects(t, box);
+        }
+
+        bool intersects(const geom_t& o) const noexcept override {
+            return intersects(o.box());
+        }
+
+        bool intersection(vec_t& reflect_out, vec_t& cross_normal, point_t& cross_point, const lineseg_t& in) const noexcept override {
+            float t;
+            if( intersects(t, in) ) {
+                cross_point = at(t);
+                cross_normal = dir.normal_ccw().normalize();
+                const vec_t v_in = cross_point - in.p0;
+                reflect_out = v_in - ( 2.0f * v_in.dot(cross_normal) * cross_normal );
+                return true;
+            }
+            return false;
+        }
+
+        /** Draws the ray from its origin across the cartesian coordinate space. */
+        void draw() const noexcept override {
+            lineseg_t::draw(orig, at(pixel::cart_coord.width() + pixel::cart_coord.height()));
+        }
+
+        /** Returns whether the origin is on screen, as the ray itself is unbound. */
+        bool on_screen() const noexcept override {
+            return orig.on_screen();
+        }
+
+        /** Returns false, as the ray is unbound. */
+        bool inside(const aabbox_t&) const noexcept override {
+            return false;
+        }
+
+        std::string toString() const noexcept override { return "Ray[orig "+orig.toString()+", dir "+dir.toString() +"]"; }
     };
 
     /**
@@ -1018,6 +1201,8 @@ namespace pixel::f2 {
             dir_angle = 0.0f;
         }
 
+        shape_t shape() const noexcept override { return shape_t::triangle; }
+
         aabbox_t box() const noexcept override {
             return aabbox_t().resize(p_a).resize(p_b).resize(p_c);
         }
@@ -1102,15 +1287,15 @@ namespace pixel::f2 {
         }
 
         bool intersects(const lineseg_t & o) const noexcept override {
-            return o.intersects(box());
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const aabbox_t& o) const noexcept override {
-            return box().intersects(o);
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const geom_t& o) const noexcept override {
-            return box().intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         bool intersection(vec_t& reflect_out, vec_t& cross_normal, point_t& cross_point, const lineseg_t& in) const noexcept override {
@@ -1234,6 +1419,8 @@ namespace pixel::f2 {
             center = p;
         }
 
+        shape_t shape() const noexcept override { return shape_t::disk; }
+
         aabbox_t box() const noexcept override {
             point_t bl = { center.x - radius, center.y - radius};
             point_t tr = { center.x + radius, center.y + radius};
@@ -1256,15 +1443,15 @@ namespace pixel::f2 {
                                        (line.p1 - line.p0).length();
             return min_distance <= radius;
             */
-            return line.intersects( box() );
+            return f2::intersects(*this, line);
         }
 
         bool intersects(const aabbox_t& o) const noexcept override {
-            return box().intersects(o);
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const geom_t& o) const noexcept override {
-            return box().intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         bool intersection(vec_t& reflect_out, vec_t& cross_normal, point_t& cross_point, const lineseg_t& in) const noexcept override {
@@ -1285,23 +1472,9 @@ namespace pixel::f2 {
         }
         void draw(const bool filled) const noexcept;
 
-        void draw_with_thickness(){
-            const float r1 = radius;
-            const float r2 = radius - thickness;
-            const float x_ival = pixel::cart_coord.width() / (float)pixel::fb_width;
-            const float y_ival = pixel::cart_coord.height() / (float)pixel::fb_height;
-            // const float ival2 = 1.0f*std::min(x_ival, y_ival);
-            const aabbox_t b = box();
-            for(float y=b.bl.y; y<=b.tr.y; y+=y_ival) {
-                for(float x=b.bl.x; x<=b.tr.x; x+=x_ival) {
-                    const point_t p { x, y };
-                    const float cp = center.dist(p);
-                    if( cp >= r2 && cp <= r1 ) {
-                        p.draw();
-                    }
-                }
-            }
-        }
+        /** Draws a ring from radius down to radius - thickness */
+        void draw_with_thickness() const noexcept;
+
         bool on_screen() const noexcept override {
             return box().on_screen();
         }
@@ -1395,6 +1568,8 @@ namespace pixel::f2 {
                    m_br == o.m_br;
         }
 
+        shape_t shape() const noexcept override { return shape_t::rect; }
+
         aabbox_t box() const noexcept override {
             return aabbox_t().resize(m_tl).resize(m_tr).resize(m_bl).resize(m_br);
         }
@@ -1458,15 +1633,15 @@ namespace pixel::f2 {
         }
 
         bool intersects(const lineseg_t & o) const noexcept override {
-            return o.intersects(box());
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const aabbox_t& o) const noexcept override {
-            return box().intersects(o);
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const geom_t& o) const noexcept override {
-            return box().intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         bool intersection(vec_t& reflect_out, vec_t& cross_normal, point_t& cross_point, const lineseg_t& in) const noexcept override {
@@ -1608,6 +1783,8 @@ namespace pixel::f2 {
             this->p_center = c / (float)n;
         }
 
+        shape_t shape() const noexcept override { return shape_t::linestrip; }
+
         aabbox_t box() const noexcept override {
             aabbox_t box;
             for(const point_t& p : p_list) {
@@ -1674,15 +1851,15 @@ namespace pixel::f2 {
         }
 
         bool intersects(const lineseg_t & o) const noexcept override {
-            return o.intersects(box());
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const aabbox_t& o) const noexcept override {
-            return box().intersects(o);
+            return f2::intersects(*this, o);
         }
 
         bool intersects(const geom_t& o) const noexcept override {
-            return box().intersects(o.box());
+            return f2::intersects(*this, o);
         }
 
         bool intersects_lineonly(const lineseg_t & o) const noexcept {
@@ -1933,6 +2110,145 @@ namespace pixel::f2 {
             return "DL[" + p0.toString() + ", " + p1.toString() + "]";
         }
     };
+
+    /**
+     * Uniform grid spatial index (broadphase) over geom_t objects, keyed by geom_t::box().
+     *
+     * Each object is referenced by all square cells of cell_size() its box() covers,
+     * objects covering more than max_object_cells are kept in a separate list tested on every query.
+     *
+     * After moving objects, call update() or update_all() to re-key them,
+     * which only touches the cells if the covered cell range has changed.
+     *
+     * Queries append each matching object once in no particular order.
+     * The index is not thread-safe, including the const queries.
+     */
+    class grid_index_t {
+    public:
+        /** Maximum number of cells an object may cover before it is kept in the oversized list. */
+        constexpr static int max_object_cells = 256;
+
+        explicit grid_index_t(const float cell_size=32.0f) noexcept;
+
+        constexpr float cell_size() const noexcept { return m_cell_size; }
+        /** Returns number of indexed objects. */
+        size_t size() const noexcept { return m_index.size(); }
+        bool contains(const geom_ref_t& g) const noexcept { return m_index.contains(g.get()); }
+
+        /** Adds given object with its current box(), returns false if already indexed. */
+        bool insert(const geom_ref_t& g) noexcept;
+        /** Re-keys given object by its current box(), returns false if not indexed. */
+        bool update(const geom_ref_t& g) noexcept;
+        /** Re-keys all indexed objects by their current box(), e.g. once per frame after ageom_t::tick(). */
+        void update_all() noexcept;
+        /** Removes given object, returns false if not indexed. */
+        bool remove(const geom_ref_t& g) noexcept;
+        void clear() noexcept;
+
+        /** Appends all objects whose box() intersects the given box to `res`, returns the number of appended objects. */
+        size_t query(geom_list_t& res, const aabbox_t& box) const noexcept;
+        /** Appends all objects whose box() intersects the given line segment to `res`, returns the number of appended objects. */
+        size_t query(geom_list_t& res, const lineseg_t& l) const noexcept;
+
+        std::string toString() const noexcept;
+
+    private:
+        struct cell_range_t {
+            int x0, y0, x1, y1;
+            constexpr bool operator==(const cell_range_t&) const noexcept = default;
+            constexpr int64_t count() const noexcept { return int64_t(x1 - x0 + 1) * int64_t(y1 - y0 + 1); }
+        };
+        struct entry_t {
+            geom_ref_t obj;
+            aabbox_t box;
+            cell_range_t cells;
+            bool oversized;
+        };
+
+        float m_cell_size;
+        float m_inv_cell_size;
+        std::vector<entry_t> m_entries;
+        std::vector<uint32_t> m_free;
+        std::vector<uint32_t> m_oversized;
+        std::unordered_map<const geom_t*, uint32_t> m_index;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+        mutable std::vector<uint32_t> m_stamps;
+        mutable uint32_t m_stamp;
+
+        constexpr static uint64_t cell_key(const int x, const int y) noexcept {
+            return ( uint64_t(uint32_t(x)) << 32 ) | uint64_t(uint32_t(y));
+        }
+        int to_cell(const float v) const noexcept;
+        cell_range_t to_cells(const aabbox_t& box) const noexcept;
+        void link(const uint32_t idx) noexcept;
+        void unlink(const uint32_t idx) noexcept;
+        uint32_t next_stamp() const noexcept;
+        size_t visit(geom_list_t& res, const std::vector<uint32_t>& idxs, const uint32_t stamp, const aabbox_t* box, const lineseg_t* l) const noexcept;
+    };
+    /**
+     * Static bounding volume hierarchy over geom_t objects, keyed by geom_t::box().
+     *
+     * Built once via build() using a median split along the longest centroid axis,
+     * intended for immutable scene layers answering overlap, nearest and ray queries in O(log n).
+     * Objects moved after build() are not re-keyed, rebuild instead.
+     */
+    class bvh_t {
+    public:
+        /** Maximum number of objects per leaf node. */
+        constexpr static uint32_t max_leaf_size = 4;
+
+        bvh_t() noexcept = default;
+        explicit bvh_t(const geom_list_t& list) noexcept { build(list); }
+
+        /** (Re)builds this hierarchy from the current box() of all given objects. */
+        void build(const geom_list_t& list) noexcept;
+        void clear() noexcept;
+
+        size_t size() const noexcept { return m_objs.size(); }
+        bool empty() const noexcept { return m_objs.empty(); }
+        /** Returns the box of all objects, reset if empty. */
+        aabbox_t box() const noexcept { return m_nodes.empty() ? aabbox_t() : m_nodes[0].box; }
+
+        /** Appends all objects whose box() intersects the given box to `res`, returns the number of appended objects. */
+        size_t query(geom_list_t& res, const aabbox_t& box) const noexcept;
+        /** Appends all objects whose box() intersects the given line segment to `res`, returns the number of appended objects. */
+        size_t query(geom_list_t& res, const lineseg_t& l) const noexcept;
+
+        /**
+         * Returns the object whose box() is nearest to the given point or nullptr if empty.
+         * @param dist storage for the distance to the box, zero if inside
+         * @param p the point
+         */
+        geom_ref_t nearest(float& dist, const point_t& p) const noexcept;
+
+        /**
+         * Returns the first object hit by the given ray within `max_dist` or nullptr if none,
+         * using geom_t::intersection() on the objects whose box() is hit.
+         * @param dist storage for the distance from the ray origin to the crossing point
+         * @param cross_point storage for the crossing point
+         * @param cross_normal storage for the normalized normal of the crossing surface
+         * @param ray the ray
+         * @param max_dist maximum distance along the ray
+         */
+        geom_ref_t raycast(float& dist, point_t& cross_point, vec_t& cross_normal,
+                           const ray_t& ray, const float max_dist=std::numeric_limits<float>::max()) const noexcept;
+
+        std::string toString() const noexcept;
+
+    private:
+        /** Leaf if count > 0 covering [first, first+count), otherwise inner node with left child at index+1 and right child at first. */
+        struct node_t {
+            aabbox_t box;
+            uint32_t first;
+            uint32_t count;
+        };
+
+        std::vector<node_t> m_nodes;
+        geom_list_t m_objs;
+        std::vector<aabbox_t> m_boxes;
+
+        uint32_t build_node(std::vector<uint32_t>& idxs, const std::vector<point_t>& centers, const uint32_t first, const uint32_t count) noexcept;
+    };
 }  // namespace pixel::f2
 
 #endif /*  PIXEL2F_HPP_ */
@@ -74,8 +74,14 @@ namespace pixel::i2 {
 
         std::string toString() const { return "L[" + p0.toString() + ", " + p1.toString() + "]"; }
 
-        static void for_all_points(const point_t& p0, const point_t& p1,
-                                   const point_action_t& point_action)
+        /**
+         * Visits all rasterized points from p0 to p1 with the given visitor `bool(const point_t& p)`,
+         * stopping if it returns false.
+         *
+         * Templated visitor allowing the call to be inlined, see the point_action_t variant.
+         */
+        template<typename Visitor>
+        static void for_all_points(const point_t& p0, const point_t& p1, Visitor&& point_action)
         {
             const int dx = p1.x - p0.x;
             const int dy = p1.y - p0.y;
@@ -103,8 +109,19 @@ namespace pixel::i2 {
                 }
             }
         }
+        static void for_all_points(const point_t& p0, const point_t& p1, const point_action_t& point_action) {
+            for_all_points<const point_action_t&>(p0, p1, point_action);
+        }
+
+        /** Appends all rasterized points from p0 to p1 to `res`, returns the number of appended points. */
+        static size_t points(std::vector<point_t>& res, const point_t& p0, const point_t& p1) {
+            const size_t n = res.size();
+            for_all_points(p0, p1, [&res](const point_t& p) -> bool { res.push_back(p); return true; });
+            return res.size() - n;
+        }
+
         static void draw(const point_t& p0, const point_t& p1) {
-            point_action_t point_draw = [&](const point_t& p) -> bool {
+            auto point_draw = [&](const point_t& p) -> bool {
                 p.draw();
                 return true;
             };
@@ -203,36 +220,22 @@ namespace pixel::i2 {
         FILLED,
         BB_INVERTED
     };
-    void draw_circle(const int cx, const int cy, const int r, const CircleDrawType mode) {
-        const int x1 = cx - r;
-        const int y1 = cy - r;
-        const int x2 = cx + r;
-        const int y2 = cy + r;
-
-        for(int y=y1; y<=y2; ++y) {
-            for(int x=x1; x<=x2; ++x) {
-                const int dx=x-cx;
-                const int dy=y-cy;
-                const int rt=jau::round_to_int( std::sqrt( (float)(dx*dx + dy*dy) ) );
-                bool draw;
-                switch( mode ) {
-                    case CircleDrawType::OUTLINE:
-                        draw = rt == r;
-                        break;
-                    case CircleDrawType::FILLED:
-                        draw = rt <= r;
-                        break;
-                    case CircleDrawType::BB_INVERTED:
-                        draw = rt >= r;
-                        break;
-                    default:
-                        draw = false;
-                        break;
-                }
-                if( draw) {
-                    pixel::set_pixel(x, y);
-                }
-            }
+    inline void draw_circle(const int cx, const int cy, const int r, const CircleDrawType mode) noexcept {
+        const int fx = cart_coord.to_fb_x( (float)cx );
+        const int fy = cart_coord.to_fb_y( (float)cy );
+        const int fr = cart_coord.to_fb_dx( (float)r );
+        switch( mode ) {
+            case CircleDrawType::OUTLINE:
+                pixel::draw_ring_fbcoord(fx, fy, fr, fr);
+                break;
+            case CircleDrawType::FILLED:
+                pixel::fill_disk_fbcoord(fx, fy, fr);
+                break;
+            case CircleDrawType::BB_INVERTED:
+                pixel::fill_disk_inverted_fbcoord(fx, fy, fr - 1, fr);
+                break;
+            default:
+                break;
         }
     }
 
@@ -356,7 +359,7 @@ namespace pixel::i2 {
 
         bool intersects(const lineseg_t& l) const {
             bool res = false;
-            lineseg_t::point_action_t point_draw = [&](const point_t& p) -> bool {
+            auto point_draw = [&](const point_t& p) -> bool {
                 res = intersects(p);
                 return !res;
             };
@@ -471,7 +474,7 @@ namespace pixel::i2 {
 
         bool intersects(const lineseg_t& l) const {
             bool res = false;
-            lineseg_t::point_action_t point_draw = [&](const point_t& p) -> bool {
+            auto point_draw = [&](const point_t& p) -> bool {
                 res = intersects(p);
                 return !res;
             };
@@ -33,9 +33,11 @@ public:
     pixel::f2::point_t last;
     pixel::f2::point_t last_last;
     pixel::f2::disk_t body;
+    /** cell size of the trail's spatial hash */
+    constexpr static const float trail_cell_size = 32.0f;
 
     Motorrad(pixel::f2::point_t sp_, float a)
-    : sp(sp_), start_angle(a), body(head, 5) 
+    : sp(sp_), start_angle(a), body(head, 5), trail(trail_cell_size)
     {
         reset();
     }
@@ -51,6 +53,7 @@ public:
             }
         }
         p_list.push_back(head);
+        add_trail_segment();
         last_last = last;
         last = head;
         //std::cout << "rot.post " << toString() << std::endl ;
@@ -77,6 +80,8 @@ public:
         body.center = head;
         p_list.clear();
         p_list.push_back(last_last);
+        trail.clear();
+        trail_last = nullptr;
         angle = start_angle;
         velo = 2.0f / 0.016f; // 2 pixel pro 16 ms
     }
@@ -101,25 +106,43 @@ public:
         const pixel::f2::lineseg_t h(head, last);
         const pixel::f2::lineseg_t o_h(o.head, o.last);
         return my_intersects(h) ||
-                o.intersects_lineonly(h) ||
+                o.trail_intersects(h, false) ||
                 o_h.intersects(h);
     }
 private:
-    bool my_intersects(const pixel::f2::lineseg_t & o) const noexcept {
-        if( p_list.size() < 3 ) {
-            return false;
+    /** Spatial hash of the trail segments of p_list, appended by rotate() */
+    pixel::f2::grid_index_t trail;
+    /** Most recent trail segment, connected to the head */
+    pixel::f2::lineseg_ref_t trail_last;
+    mutable pixel::f2::geom_list_t trail_hits;
+
+    void add_trail_segment() noexcept {
+        if( p_list.size() < 2 ) {
+            return;
         }
-        pixel::f2::point_t p0 = p_list[0];
-        for(size_t i=1; i<p_list.size()-1; ++i) {
-            const pixel::f2::point_t& p1 = p_list[i];
-            const pixel::f2::lineseg_t l(p0, p1);
-            if( l.intersects(o) ) {
+        trail_last = std::make_shared<pixel::f2::lineseg_t>(p_list[p_list.size()-2], p_list[p_list.size()-1]);
+        trail.insert(trail_last);
+    }
+
+    /**
+     * Returns whether the given line segment intersects the trail,
+     * only testing the segments in cells nearby instead of the whole p_list.
+     */
+    bool trail_intersects(const pixel::f2::lineseg_t & o, const bool skip_last) const noexcept {
+        trail_hits.clear();
+        trail.query(trail_hits, o);
+        for(const pixel::f2::geom_ref_t& l : trail_hits) {
+            if( ( !skip_last || l != trail_last ) && l->intersects(o) ) {
                 return true;
             }
-            p0 = p1;
         }
         return false;
     }
+
+    bool my_intersects(const pixel::f2::lineseg_t & o) const noexcept {
+        // skip the most recent segment, connected to the head segment
+        return trail_intersects(o, true);
+    }
 };
 
 class peng_t {
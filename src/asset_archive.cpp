@@ -0,0 +1,181 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "pixel/pixel.hpp"
+#include "pixel/asset_archive.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pixel;
+using namespace jau;
+
+namespace {
+    /** The memory-mapped asset archive */
+    struct mapped_archive_t {
+        std::string fname;
+        const uint8_t* base = nullptr;
+        size_t size = 0;
+        /** Fallback copy if mmap is not available */
+        std::vector<uint8_t> copy;
+        const archive::entry_t* index = nullptr;
+        uint32_t count = 0;
+        const char* names = nullptr;
+        size_t names_size = 0;
+
+        ~mapped_archive_t() noexcept { close(); }
+
+        void close() noexcept {
+            if( nullptr != base && copy.empty() ) {
+                ::munmap(const_cast<uint8_t*>(base), size);
+            }
+            copy.clear();
+            base = nullptr;
+            size = 0;
+            index = nullptr;
+            count = 0;
+            names = nullptr;
+            names_size = 0;
+            fname.clear();
+        }
+
+        std::string_view name_of(const archive::entry_t& e) const noexcept {
+            if( uint64_t(e.name_offset) + e.name_length > names_size ) {
+                return std::string_view();
+            }
+            return std::string_view(names + e.name_offset, e.name_length);
+        }
+    };
+    mapped_archive_t mapped_archive;
+
+    bool validate(const mapped_archive_t& a) noexcept {
+        for(uint32_t i=0; i<a.count; ++i) {
+            const archive::entry_t& e = a.index[i];
+            if( e.offset > a.size || e.length > a.size - e.offset || a.name_of(e).size() != e.name_length ) {
+                return false;
+            }
+            if( 0 < i && a.index[i-1].hash > e.hash ) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool pixel::open_asset_archive(const std::string& fname) noexcept {
+    close_asset_archive();
+    const int fd = ::open(fname.c_str(), O_RDONLY);
+    if( 0 > fd ) {
+        log_printf("asset_archive: Error opening '%s'\n", fname.c_str());
+        return false;
+    }
+    struct stat st;
+    if( 0 != ::fstat(fd, &st) || st.st_size < (off_t)sizeof(archive::header_t) ) {
+        log_printf("asset_archive: Invalid size of '%s'\n", fname.c_str());
+        ::close(fd);
+        return false;
+    }
+    mapped_archive_t& a = mapped_archive;
+    a.size = size_t(st.st_size);
+    void* m = ::mmap(nullptr, a.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if( MAP_FAILED != m ) {
+        a.base = reinterpret_cast<const uint8_t*>(m);
+    } else {
+        // e.g. no mmap support of the file system
+        a.copy.resize(a.size);
+        size_t n = 0;
+        while( n < a.size ) {
+            const ssize_t r = ::read(fd, a.copy.data() + n, a.size - n);
+            if( 0 >= r ) {
+                break;
+            }
+            n += size_t(r);
+        }
+        if( n != a.size ) {
+            log_printf("asset_archive: Error reading '%s'\n", fname.c_str());
+            ::close(fd);
+            a.close();
+            return false;
+        }
+        a.base = a.copy.data();
+    }
+    ::close(fd);
+
+    archive::header_t h;
+    std::memcpy(&h, a.base, sizeof(h));
+    const uint64_t index_size = uint64_t(h.count) * sizeof(archive::entry_t);
+    if( 0 != std::memcmp(h.magic, archive::magic, sizeof(h.magic)) || archive::version != h.version ||
+        h.index_offset % alignof(archive::entry_t) ||
+        h.index_offset > a.size || index_size > a.size - h.index_offset ||
+        h.names_offset > a.size )
+    {
+        log_printf("asset_archive: Invalid header of '%s'\n", fname.c_str());
+        a.close();
+        return false;
+    }
+    // base is page aligned or heap allocated, index_offset is aligned to entry_t
+    a.index = std::bit_cast<const archive::entry_t*>(a.base + h.index_offset);
+    a.count = h.count;
+    a.names = reinterpret_cast<const char*>(a.base + h.names_offset);
+    a.names_size = a.size - h.names_offset;
+    if( !validate(a) ) {
+        log_printf("asset_archive: Invalid index of '%s'\n", fname.c_str());
+        a.close();
+        return false;
+    }
+    a.fname = fname;
+    log_printf("asset_archive: Mapped '%s', %u assets, %zu bytes\n", fname.c_str(), a.count, a.size);
+    return true;
+}
+
+void pixel::close_asset_archive() noexcept {
+    mapped_archive.close();
+}
+
+std::string pixel::asset_archive() noexcept { return mapped_archive.fname; }
+
+pixel::asset_data_t pixel::find_archived_asset(const std::string& asset_file) noexcept {
+    const mapped_archive_t& a = mapped_archive;
+    if( 0 == a.count ) {
+        return asset_data_t();
+    }
+    const uint64_t h = archive::hash(asset_file);
+    const archive::entry_t* end = a.index + a.count;
+    const archive::entry_t* it = std::lower_bound(a.index, end, h,
+            [](const archive::entry_t& e, const uint64_t v) { return e.hash < v; });
+    for(; it != end && it->hash == h; ++it) {
+        if( a.name_of(*it) == asset_file ) {
+            return asset_data_t { .data=a.base + it->offset, .size=size_t(it->length) };
+        }
+    }
+    return asset_data_t();
+}
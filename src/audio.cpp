@@ -92,6 +92,11 @@ void jau::audio::audio_close() {
 }
 
 static Mix_Chunk* Mix_LoadWAV2(const std::string& f) {
+    const pixel::asset_data_t packed = pixel::find_archived_asset(f);
+    if( packed.valid() ) {
+        // decode straight from the mapped asset archive
+        return Mix_LoadWAV_RW(SDL_RWFromConstMem(packed.data, int(packed.size)), 1);
+    }
     const std::string g = pixel::resolve_asset(f);
     if( g.size() > 0 ) {
         return Mix_LoadWAV(g.c_str());
@@ -109,6 +114,15 @@ jau::audio::audio_sample_t::audio_sample_t(const std::string &fname, const bool
     }
 }
 
+jau::audio::audio_sample_future jau::audio::load_sample_async(const std::string &fname, const bool single_play, const int volume) {
+    std::shared_ptr<std::promise<audio_sample_ref>> res = std::make_shared<std::promise<audio_sample_ref>>();
+    audio_sample_future f = res->get_future().share();
+    pixel::asset_loader_submit(fname, [res, fname, single_play, volume]() {
+        res->set_value( std::make_shared<audio_sample_t>(fname, single_play, volume) );
+    });
+    return f;
+}
+
 void jau::audio::audio_sample_t::play(int loops) {
     if ( audio_subsystem_init && nullptr != chunk.get() ) {
         if( !singly || 0 > channel_playing || ( 0 <= channel_playing && 0 == Mix_Playing(channel_playing) ) ) {
@@ -23,6 +23,7 @@
  */
 #include "jau/file_util.hpp"
 #include <strings.h>
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 
@@ -148,6 +149,53 @@ bool jau::fs::exists(const std::string& path) noexcept {
     return 0 == stat_res; // errno EACCES=no access, ENOENT=not existing
 }
 
+/** Directories already listed by list_files_impl(), identified by device and inode to stop at symlink cycles. */
+typedef std::vector<std::pair<dev_t, ino_t>> dir_ids_t;
+
+static bool list_files_impl(const std::string& dir, const std::string& prefix, std::vector<std::string>& files, dir_ids_t& visited) noexcept {
+    struct stat ds;
+    if( 0 != ::stat(dir.c_str(), &ds) ) {
+        return false;
+    }
+    const std::pair<dev_t, ino_t> id(ds.st_dev, ds.st_ino);
+    if( visited.end() != std::find(visited.begin(), visited.end(), id) ) {
+        return true; // symlink cycle like 'x -> ..', or a directory linked twice
+    }
+    DIR* d = ::opendir(dir.c_str());
+    if( nullptr == d ) {
+        return false;
+    }
+    visited.push_back(id);
+    struct dirent* e;
+    while( nullptr != ( e = ::readdir(d) ) ) {
+        if( '.' == e->d_name[0] ) {
+            continue; // hidden, '.' and '..'
+        }
+        const std::string path = dir+"/"+e->d_name;
+        const std::string name = prefix+e->d_name;
+        unsigned char type = e->d_type;
+        if( DT_UNKNOWN == type || DT_LNK == type ) {
+            struct stat s;
+            if( 0 != ::stat(path.c_str(), &s) ) {
+                continue;
+            }
+            type = S_ISDIR(s.st_mode) ? DT_DIR : ( S_ISREG(s.st_mode) ? DT_REG : DT_UNKNOWN );
+        }
+        if( DT_DIR == type ) {
+            list_files_impl(path, name+"/", files, visited);
+        } else if( DT_REG == type ) {
+            files.push_back(name);
+        }
+    }
+    ::closedir(d);
+    return true;
+}
+
+bool jau::fs::list_files(const std::string& dir, std::vector<std::string>& files) noexcept {
+    dir_ids_t visited;
+    return list_files_impl(dir, "", files, visited);
+}
+
 std::string jau::fs::lookup_asset_dir(const char* exe_path, const char* asset_file, const char* asset_install_subdir) noexcept {
     if( !asset_file ) {
         return "";
@@ -0,0 +1,386 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "pixel/kernel.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define PIXEL_KERNEL_X86 1
+    #include <immintrin.h>
+#endif
+
+using namespace pixel::kernel;
+
+//
+// Scalar
+//
+
+static void fill_scalar(uint32_t* dst, size_t count, uint32_t value) noexcept {
+    std::fill_n(dst, count, value);
+}
+
+/** Returns x / 255 rounded to nearest, exact for x <= 255*255 */
+static constexpr uint32_t div255(uint32_t x) noexcept {
+    x += 128;
+    return ( x + ( x >> 8 ) ) >> 8;
+}
+
+static void blend_scalar(uint32_t* dst, size_t count, uint32_t src) noexcept {
+    const uint32_t a = src >> 24;
+    const uint32_t ia = 255 - a;
+    // source channels premultiplied by alpha, alpha channel composed as 255 * a
+    const uint32_t sb = ( src         & 0xffU) * a;
+    const uint32_t sg = ( (src >>  8) & 0xffU) * a;
+    const uint32_t sr = ( (src >> 16) & 0xffU) * a;
+    const uint32_t sa = 255U * a;
+    for(size_t i=0; i<count; ++i) {
+        const uint32_t d = dst[i];
+        dst[i] = ( div255( sa + ( d >> 24         ) * ia ) << 24 ) |
+                 ( div255( sr + ((d >> 16) & 0xffU) * ia ) << 16 ) |
+                 ( div255( sg + ((d >>  8) & 0xffU) * ia ) <<  8 ) |
+                   div255( sb + ( d        & 0xffU) * ia );
+    }
+}
+
+static void blend_over_scalar(uint32_t* dst, const uint32_t* src, size_t count) noexcept {
+    for(size_t i=0; i<count; ++i) {
+        const uint32_t s = src[i];
+        const uint32_t a = s >> 24;
+        if( 255 == a ) {
+            dst[i] = s;
+        } else if( 0 < a ) {
+            const uint32_t ia = 255 - a;
+            const uint32_t d = dst[i];
+            dst[i] = ( div255( 255U * a                  + ( d >> 24         ) * ia ) << 24 ) |
+                     ( div255( ((s >> 16) & 0xffU) * a + ((d >> 16) & 0xffU) * ia ) << 16 ) |
+                     ( div255( ((s >>  8) & 0xffU) * a + ((d >>  8) & 0xffU) * ia ) <<  8 ) |
+                       div255( ( s        & 0xffU) * a + ( d        & 0xffU) * ia );
+        }
+    }
+}
+
+static bool equals_scalar(const uint32_t* src, size_t count, uint32_t value) noexcept {
+    for(size_t i=0; i<count; ++i) {
+        if( value != src[i] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(PIXEL_KERNEL_X86)
+
+//
+// SSE2
+//
+
+__attribute__((target("sse2")))
+static void fill_sse2(uint32_t* dst, size_t count, uint32_t value) noexcept {
+    for(; 0 < count && 0 != ( reinterpret_cast<uintptr_t>(dst) & 15 ); --count) {
+        *dst++ = value;
+    }
+    const __m128i v = _mm_set1_epi32( static_cast<int>(value) );
+    for(; count >= 8; count -= 8, dst += 8) {
+        _mm_store_si128(static_cast<__m128i*>(static_cast<void*>(dst)), v);
+        _mm_store_si128(static_cast<__m128i*>(static_cast<void*>(dst + 4)), v);
+    }
+    for(; count >= 4; count -= 4, dst += 4) {
+        _mm_store_si128(static_cast<__m128i*>(static_cast<void*>(dst)), v);
+    }
+    while( count-- ) {
+        *dst++ = value;
+    }
+}
+
+__attribute__((target("sse2")))
+static void blend_sse2(uint32_t* dst, size_t count, uint32_t src) noexcept {
+    const short a = static_cast<short>(src >> 24);
+    const short b = static_cast<short>( src        & 0xffU);
+    const short g = static_cast<short>((src >>  8) & 0xffU);
+    const short r = static_cast<short>((src >> 16) & 0xffU);
+    const __m128i zero = _mm_setzero_si128();
+    // byte order b, g, r, a per pixel, alpha channel composed as 255 * a
+    const __m128i s_term = _mm_add_epi16( _mm_mullo_epi16( _mm_setr_epi16(b, g, r, 255, b, g, r, 255), _mm_set1_epi16(a) ),
+                                          _mm_set1_epi16(128) );
+    const __m128i ia = _mm_set1_epi16( static_cast<short>(255 - a) );
+    for(; count >= 4; count -= 4, dst += 4) {
+        __m128i* p = static_cast<__m128i*>(static_cast<void*>(dst));
+        const __m128i d = _mm_loadu_si128(p);
+        __m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8(d, zero), ia ), s_term );
+        __m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8(d, zero), ia ), s_term );
+        lo = _mm_srli_epi16( _mm_add_epi16( lo, _mm_srli_epi16(lo, 8) ), 8 );
+        hi = _mm_srli_epi16( _mm_add_epi16( hi, _mm_srli_epi16(hi, 8) ), 8 );
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    blend_scalar(dst, count, src);
+}
+
+/** Blends 2 pixel of s16 over d16, unpacked to 16-bit channels b, g, r, a */
+__attribute__((target("sse2")))
+static inline __m128i blend_over2_sse2(__m128i s16, __m128i d16) noexcept {
+    const __m128i a = _mm_shufflehi_epi16( _mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3) );
+    const __m128i ia = _mm_sub_epi16( _mm_set1_epi16(255), a );
+    // alpha channel composed as 255 * a
+    s16 = _mm_or_si128( _mm_and_si128(s16, _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0)), _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255) );
+    __m128i v = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16(s16, a), _mm_mullo_epi16(d16, ia) ), _mm_set1_epi16(128) );
+    return _mm_srli_epi16( _mm_add_epi16( v, _mm_srli_epi16(v, 8) ), 8 );
+}
+
+__attribute__((target("sse2")))
+static void blend_over_sse2(uint32_t* dst, const uint32_t* src, size_t count) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    for(; count >= 4; count -= 4, dst += 4, src += 4) {
+        __m128i* p = static_cast<__m128i*>(static_cast<void*>(dst));
+        const __m128i s = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(src)));
+        const __m128i d = _mm_loadu_si128(p);
+        const __m128i lo = blend_over2_sse2( _mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero) );
+        const __m128i hi = blend_over2_sse2( _mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero) );
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    blend_over_scalar(dst, src, count);
+}
+
+__attribute__((target("sse2")))
+static bool equals_sse2(const uint32_t* src, size_t count, uint32_t value) noexcept {
+    const __m128i v = _mm_set1_epi32( static_cast<int>(value) );
+    for(; count >= 4; count -= 4, src += 4) {
+        const __m128i s = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(src)));
+        if( 0xffff != _mm_movemask_epi8( _mm_cmpeq_epi32(s, v) ) ) {
+            return false;
+        }
+    }
+    return equals_scalar(src, count, value);
+}
+
+//
+// AVX2
+//
+
+__attribute__((target("avx2")))
+static void fill_avx2(uint32_t* dst, size_t count, uint32_t value) noexcept {
+    for(; 0 < count && 0 != ( reinterpret_cast<uintptr_t>(dst) & 31 ); --count) {
+        *dst++ = value;
+    }
+    const __m256i v = _mm256_set1_epi32( static_cast<int>(value) );
+    for(; count >= 16; count -= 16, dst += 16) {
+        _mm256_store_si256(static_cast<__m256i*>(static_cast<void*>(dst)), v);
+        _mm256_store_si256(static_cast<__m256i*>(static_cast<void*>(dst + 8)), v);
+    }
+    for(; count >= 8; count -= 8, dst += 8) {
+        _mm256_store_si256(static_cast<__m256i*>(static_cast<void*>(dst)), v);
+    }
+    while( count-- ) {
+        *dst++ = value;
+    }
+}
+
+__attribute__((target("avx2")))
+static void blend_avx2(uint32_t* dst, size_t count, uint32_t src) noexcept {
+    const short a = static_cast<short>(src >> 24);
+    const short b = static_cast<short>( src        & 0xffU);
+    const short g = static_cast<short>((src >>  8) & 0xffU);
+    const short r = static_cast<short>((src >> 16) & 0xffU);
+    const __m256i zero = _mm256_setzero_si256();
+    // byte order b, g, r, a per pixel, alpha channel composed as 255 * a
+    const __m256i s_term = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_setr_epi16(b, g, r, 255, b, g, r, 255, b, g, r, 255, b, g, r, 255),
+                                                                 _mm256_set1_epi16(a) ),
+                                             _mm256_set1_epi16(128) );
+    const __m256i ia = _mm256_set1_epi16( static_cast<short>(255 - a) );
+    for(; count >= 8; count -= 8, dst += 8) {
+        __m256i* p = static_cast<__m256i*>(static_cast<void*>(dst));
+        const __m256i d = _mm256_loadu_si256(p);
+        // unpack and pack operate per 128-bit lane, hence preserving the pixel order
+        __m256i lo = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpacklo_epi8(d, zero), ia ), s_term );
+        __m256i hi = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpackhi_epi8(d, zero), ia ), s_term );
+        lo = _mm256_srli_epi16( _mm256_add_epi16( lo, _mm256_srli_epi16(lo, 8) ), 8 );
+        hi = _mm256_srli_epi16( _mm256_add_epi16( hi, _mm256_srli_epi16(hi, 8) ), 8 );
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    blend_sse2(dst, count, src);
+}
+
+/** Blends 4 pixel of s16 over d16, unpacked to 16-bit channels b, g, r, a */
+__attribute__((target("avx2")))
+static inline __m256i blend_over4_avx2(__m256i s16, __m256i d16) noexcept {
+    const __m256i a = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3) );
+    const __m256i ia = _mm256_sub_epi16( _mm256_set1_epi16(255), a );
+    // alpha channel composed as 255 * a
+    s16 = _mm256_or_si256( _mm256_and_si256(s16, _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0)),
+                           _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255) );
+    __m256i v = _mm256_add_epi16( _mm256_add_epi16( _mm256_mullo_epi16(s16, a), _mm256_mullo_epi16(d16, ia) ), _mm256_set1_epi16(128) );
+    return _mm256_srli_epi16( _mm256_add_epi16( v, _mm256_srli_epi16(v, 8) ), 8 );
+}
+
+__attribute__((target("avx2")))
+static void blend_over_avx2(uint32_t* dst, const uint32_t* src, size_t count) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    for(; count >= 8; count -= 8, dst += 8, src += 8) {
+        __m256i* p = static_cast<__m256i*>(static_cast<void*>(dst));
+        const __m256i s = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(src)));
+        const __m256i d = _mm256_loadu_si256(p);
+        // unpack and pack operate per 128-bit lane, hence preserving the pixel order
+        const __m256i lo = blend_over4_avx2( _mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero) );
+        const __m256i hi = blend_over4_avx2( _mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero) );
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    blend_over_sse2(dst, src, count);
+}
+
+__attribute__((target("avx2")))
+static bool equals_avx2(const uint32_t* src, size_t count, uint32_t value) noexcept {
+    const __m256i v = _mm256_set1_epi32( static_cast<int>(value) );
+    for(; count >= 8; count -= 8, src += 8) {
+        const __m256i s = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(src)));
+        if( -1 != _mm256_movemask_epi8( _mm256_cmpeq_epi32(s, v) ) ) {
+            return false;
+        }
+    }
+    return equals_sse2(src, count, value);
+}
+
+#endif /* PIXEL_KERNEL_X86 */
+
+//
+// Dispatch
+//
+
+namespace {
+    struct kernels_t {
+        isa_t isa;
+        void (*fill)(uint32_t*, size_t, uint32_t) noexcept;
+        void (*blend)(uint32_t*, size_t, uint32_t) noexcept;
+        void (*blend_over)(uint32_t*, const uint32_t*, size_t) noexcept;
+        bool (*equals)(const uint32_t*, size_t, uint32_t) noexcept;
+    };
+
+    bool supported_impl(const isa_t v) noexcept {
+        switch( v ) {
+#if defined(PIXEL_KERNEL_X86)
+            case isa_t::avx2:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2");
+            case isa_t::sse2:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse2");
+#endif
+            case isa_t::scalar:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    kernels_t make_kernels(const isa_t v) noexcept {
+        switch( v ) {
+#if defined(PIXEL_KERNEL_X86)
+            case isa_t::avx2:
+                return kernels_t { isa_t::avx2, fill_avx2, blend_avx2, blend_over_avx2, equals_avx2 };
+            case isa_t::sse2:
+                return kernels_t { isa_t::sse2, fill_sse2, blend_sse2, blend_over_sse2, equals_sse2 };
+#endif
+            default:
+                return kernels_t { isa_t::scalar, fill_scalar, blend_scalar, blend_over_scalar, equals_scalar };
+        }
+    }
+
+    kernels_t detect() noexcept {
+        if( supported_impl(isa_t::avx2) ) {
+            return make_kernels(isa_t::avx2);
+        }
+        if( supported_impl(isa_t::sse2) ) {
+            return make_kernels(isa_t::sse2);
+        }
+        return make_kernels(isa_t::scalar);
+    }
+
+    kernels_t& kernels() noexcept {
+        static kernels_t k = detect();
+        return k;
+    }
+}
+
+isa_t pixel::kernel::isa() noexcept { return kernels().isa; }
+
+bool pixel::kernel::supported(isa_t v) noexcept { return supported_impl(v); }
+
+bool pixel::kernel::set_isa(isa_t v) noexcept {
+    if( !supported_impl(v) ) {
+        return false;
+    }
+    kernels() = make_kernels(v);
+    return true;
+}
+
+const char* pixel::kernel::to_string(isa_t v) noexcept {
+    switch( v ) {
+        case isa_t::sse2: return "SSE2";
+        case isa_t::avx2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+void pixel::kernel::fill(uint32_t* dst, size_t count, uint32_t value) noexcept {
+    kernels().fill(dst, count, value);
+}
+
+void pixel::kernel::fill_rect(uint32_t* dst, size_t stride, size_t width, size_t height, uint32_t value) noexcept {
+    const kernels_t& k = kernels();
+    if( stride == width ) {
+        k.fill(dst, width * height, value);
+        return;
+    }
+    for(size_t y=0; y<height; ++y, dst += stride) {
+        k.fill(dst, width, value);
+    }
+}
+
+void pixel::kernel::blend(uint32_t* dst, size_t count, uint32_t src) noexcept {
+    const uint32_t a = src >> 24;
+    if( 255 == a ) {
+        kernels().fill(dst, count, src);
+    } else if( 0 < a ) {
+        kernels().blend(dst, count, src);
+    }
+}
+
+void pixel::kernel::blend_over(uint32_t* dst, const uint32_t* src, size_t count) noexcept {
+    kernels().blend_over(dst, src, count);
+}
+
+bool pixel::kernel::equals(const uint32_t* src, size_t count, uint32_t value) noexcept {
+    return kernels().equals(src, count, value);
+}
+
+bool pixel::kernel::equals_rect(const uint32_t* src, size_t stride, size_t width, size_t height, uint32_t value) noexcept {
+    const kernels_t& k = kernels();
+    if( stride == width ) {
+        return k.equals(src, width * height, value);
+    }
+    for(size_t y=0; y<height; ++y, src += stride) {
+        if( !k.equals(src, width, value) ) {
+            return false;
+        }
+    }
+    return true;
+}
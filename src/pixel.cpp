@@ -32,6 +32,13 @@
 #include <ctime>
 #include <string>
 #include <vector>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <sys/types.h>
 
 #include <jau/utils.hpp>
@@ -50,6 +57,9 @@ int pixel::fb_height=0;
 int pixel::fb_max_x=0;
 int pixel::fb_max_y=0;
 pixel::pixel_buffer_t pixel::fb_pixels;
+uint32_t* pixel::fb_data = nullptr;
+int pixel::fb_stride = 0;
+pixel::fb_region_t pixel::fb_dirty;
 
 int pixel::font_height = 24;
 
@@ -63,23 +73,101 @@ static std::string m_asset_dir;
 //
 //
 
-std::string pixel::lookup_and_register_asset_dir(const char* exe_path, const char* asset_file, const char* asset_install_subdir) noexcept {
+namespace {
+    /** Resolved asset paths by name, including negative lookups as empty paths */
+    struct asset_path_cache_t {
+        std::mutex mtx;
+        /** absolute asset directory */
+        std::string abs_dir;
+        std::unordered_map<std::string, std::string> paths;
+        /** paths resolved with lookup_direct, may differ from paths */
+        std::unordered_map<std::string, std::string> direct_paths;
+        /** true if paths holds the pre-scanned files of the asset directory, misses are still probed */
+        bool complete = false;
+        pixel::asset_path_stats_t stats;
+    };
+    asset_path_cache_t asset_paths;
+}
+
+std::string pixel::lookup_and_register_asset_dir(const char* exe_path, const char* asset_file, const char* asset_install_subdir, bool prescan) noexcept {
+    std::unique_lock<std::mutex> lock(asset_paths.mtx);
+    const jau::fraction_timespec t0 = jau::getMonotonicTime();
     m_asset_dir = jau::fs::lookup_asset_dir(exe_path, asset_file, asset_install_subdir);
+    const jau::fraction_timespec t1 = jau::getMonotonicTime();
+    asset_paths.abs_dir = m_asset_dir.size() ? jau::fs::absolute(m_asset_dir) : "";
+    if( m_asset_dir.size() && asset_paths.abs_dir.empty() ) {
+        asset_paths.abs_dir = m_asset_dir;
+    }
+    asset_paths.paths.clear();
+    asset_paths.direct_paths.clear();
+    asset_paths.complete = false;
+    asset_paths.stats = asset_path_stats_t();
+    asset_paths.stats.dir_lookup_us = (uint64_t)(t1 - t0).to_us();
+    if( prescan && asset_paths.abs_dir.size() ) {
+        std::vector<std::string> files;
+        if( jau::fs::list_files(asset_paths.abs_dir, files) ) {
+            for(const std::string& f : files) {
+                asset_paths.paths[f] = asset_paths.abs_dir+"/"+f;
+            }
+            asset_paths.complete = true;
+            asset_paths.stats.prescanned = files.size();
+        }
+        asset_paths.stats.prescan_us = (uint64_t)(jau::getMonotonicTime() - t1).to_us();
+    }
+    log_printf("asset_dir: '%s' -> '%s', %s\n", m_asset_dir.c_str(), asset_paths.abs_dir.c_str(), asset_paths.stats.toString().c_str());
     return m_asset_dir;
 }
 std::string pixel::asset_dir() noexcept { return m_asset_dir; }
 
 std::string pixel::resolve_asset(const std::string &asset_file, bool lookup_direct) noexcept {
-    if( lookup_direct && jau::fs::exists(asset_file) ) {
-        return asset_file;
+    std::unique_lock<std::mutex> lock(asset_paths.mtx);
+    const jau::fraction_timespec t0 = jau::getMonotonicTime();
+    asset_path_stats_t& stats = asset_paths.stats;
+    ++stats.lookups;
+    std::unordered_map<std::string, std::string>& cache = lookup_direct ? asset_paths.direct_paths : asset_paths.paths;
+    auto it = cache.find(asset_file);
+    if( it != cache.end() ) {
+        ++stats.cached;
+        stats.resolve_us += (uint64_t)(jau::getMonotonicTime() - t0).to_us();
+        return it->second;
+    }
+    std::string res;
+    if( lookup_direct ) {
+        ++stats.probes;
+        if( jau::fs::exists(asset_file) ) {
+            res = asset_file;
+        }
     }
-    if( m_asset_dir.size() ) {
-        std::string fname1 = m_asset_dir+"/"+asset_file;
-        if( jau::fs::exists(fname1) ) {
-            return fname1;
+    if( res.empty() && asset_paths.abs_dir.size() ) {
+        if( asset_paths.complete ) {
+            auto it2 = asset_paths.paths.find(asset_file);
+            if( it2 != asset_paths.paths.end() ) {
+                res = it2->second;
+            }
+        }
+        if( res.empty() ) {
+            // not pre-scanned, or missed by the pre-scan, e.g. hidden or behind an already listed directory link
+            ++stats.probes;
+            std::string fname1 = asset_paths.abs_dir+"/"+asset_file;
+            if( jau::fs::exists(fname1) ) {
+                res = std::move(fname1);
+            }
         }
     }
-    return "";
+    cache[asset_file] = res;
+    stats.resolve_us += (uint64_t)(jau::getMonotonicTime() - t0).to_us();
+    return res;
+}
+
+std::string pixel::asset_path_stats_t::toString() const noexcept {
+    return "asset_paths[lookups "+std::to_string(lookups)+", cached "+std::to_string(cached)+", probes "+std::to_string(probes)+
+           ", prescanned "+std::to_string(prescanned)+", dir lookup "+std::to_string(double(dir_lookup_us)/1000.0)+
+           " ms, prescan "+std::to_string(double(prescan_us)/1000.0)+" ms, resolve "+std::to_string(double(resolve_us)/1000.0)+" ms]";
+}
+
+pixel::asset_path_stats_t pixel::asset_path_stats() noexcept {
+    std::unique_lock<std::mutex> lock(asset_paths.mtx);
+    return asset_paths.stats;
 }
 
 //
@@ -91,7 +179,8 @@ void pixel::draw_line(float x1_, float y1_, float x2_, float y2_) noexcept {
         subsys_draw_line(cart_coord.to_fb_x( x1_ ), cart_coord.to_fb_y( y1_ ),
                          cart_coord.to_fb_x( x2_ ), cart_coord.to_fb_y( y2_ ));
     } else {
-        pixel::f2::lineseg_t::draw({ x1_, y1_ }, { x2_, y1_ });
+        draw_line_fbcoord(cart_coord.to_fb_x( x1_ ), cart_coord.to_fb_y( y1_ ),
+                          cart_coord.to_fb_x( x2_ ), cart_coord.to_fb_y( y2_ ));
     }
 }
 
@@ -119,6 +208,640 @@ void pixel::draw_grid(float raster_sz,
     pixel::draw_line(0, -raster_sz, 0, +raster_sz);
 }
 
+//
+// Clipped rasterizer
+//
+
+namespace {
+    /**
+     * Midpoint disk row stepper, yielding the half width of a disk of radius r
+     * for non-decreasing row offsets dy using integer arithmetic only.
+     *
+     * A pixel at dx/dy is covered if dx*dx + dy*dy <= r*r + r, i.e. its distance is less than r + 1/2.
+     */
+    class disk_rows_t {
+        private:
+            int64_t m_rr;
+            int m_x;
+
+        public:
+            /** Start stepping at row offset dy0 */
+            disk_rows_t(const int r, const int dy0) noexcept
+            : m_rr( (int64_t)r*r + r ),
+              m_x( 0 > r ? -1 : (int)std::sqrt( (double)std::max<int64_t>(0, m_rr - (int64_t)dy0*dy0) ) + 1 ) {}
+
+            /** Returns the half width at given row offset dy, or -1 if the row is not covered. */
+            int half_width(const int dy) noexcept {
+                const int64_t dy2 = (int64_t)dy*dy;
+                while( 0 <= m_x && (int64_t)m_x*m_x + dy2 > m_rr ) {
+                    --m_x;
+                }
+                return m_x;
+            }
+    };
+}
+
+/**
+ * Emits the horizontal spans `emit(x1, x2, y)` of the disk r_out (or the square with half width r_out if box is true),
+ * excluding the disk r_excl if r_excl >= 0. Only rows within clip are stepped, spans are clipped.
+ */
+template<typename Emit>
+static void disk_spans(const pixel::fb_region_t& clip, const int cx, const int cy, const int r_out, const int r_excl, const bool box, Emit emit) noexcept {
+    if( 0 > r_out || cy - r_out > clip.y2 || cy + r_out < clip.y1 || cx - r_out > clip.x2 || cx + r_out < clip.x1 ) {
+        return;
+    }
+    auto add_span = [&](const int x1, const int x2, const int y) {
+        const int lo = std::max(clip.x1, x1);
+        const int hi = std::min(clip.x2, x2);
+        if( lo <= hi ) {
+            emit(lo, hi, y);
+        }
+    };
+    for(int half=0; half<2; ++half) {
+        // half 0: rows cy - dy with dy >= 0, half 1: rows cy + dy with dy >= 1
+        const int dy0 = 0 == half ? std::max(0, cy - clip.y2) : std::max(1, clip.y1 - cy);
+        const int dy1 = std::min(r_out, 0 == half ? cy - clip.y1 : clip.y2 - cy);
+        disk_rows_t outer(r_out, dy0), inner(r_excl, dy0);
+        for(int dy=dy0; dy<=dy1; ++dy) {
+            const int y = 0 == half ? cy - dy : cy + dy;
+            const int xo = box ? r_out : outer.half_width(dy);
+            const int xi = inner.half_width(dy);
+            if( 0 > xo ) {
+                break;
+            } else if( 0 > xi ) {
+                add_span(cx - xo, cx + xo, y);
+            } else if( xo > xi ) {
+                add_span(cx - xo, cx - xi - 1, y);
+                add_span(cx + xi + 1, cx + xo, y);
+            }
+        }
+    }
+}
+
+/**
+ * Emits the horizontal spans `emit(x1, x2, y)` of the given triangle, one per row,
+ * including pixels on its edges. Only rows within clip are stepped, spans are clipped.
+ */
+template<typename Emit>
+static void triangle_spans(const pixel::fb_region_t& clip, int x1, int y1, int x2, int y2, int x3, int y3, Emit emit) noexcept {
+    // sort by y ascending, (x1, y1) top and (x3, y3) bottom in fb space
+    if( y1 > y2 ) { std::swap(x1, x2); std::swap(y1, y2); }
+    if( y2 > y3 ) { std::swap(x2, x3); std::swap(y2, y3); }
+    if( y1 > y2 ) { std::swap(x1, x2); std::swap(y1, y2); }
+
+    const int y_min = std::max(clip.y1, y1);
+    const int y_max = std::min(clip.y2, y3);
+    if( y_min > y_max ) {
+        return;
+    }
+    const int ex[3][4] = { { x1, y1, x3, y3 }, { x1, y1, x2, y2 }, { x2, y2, x3, y3 } };
+
+    for(int y=y_min; y<=y_max; ++y) {
+        double xl = std::numeric_limits<double>::max();
+        double xr = -std::numeric_limits<double>::max();
+        for(const int* e : ex) {
+            // e[1] <= e[3] due to sorted vertices
+            if( y < e[1] || e[3] < y ) {
+                continue;
+            }
+            if( e[1] == e[3] ) {
+                // horizontal edge on this row, covers both end points
+                xl = std::min<double>(xl, std::min(e[0], e[2]));
+                xr = std::max<double>(xr, std::max(e[0], e[2]));
+            } else {
+                const double x = e[0] + double( (int64_t)(y - e[1]) * (e[2] - e[0]) ) / double(e[3] - e[1]);
+                xl = std::min(xl, x);
+                xr = std::max(xr, x);
+            }
+        }
+        const int lo = std::max(clip.x1, (int)std::ceil(xl));
+        const int hi = std::min(clip.x2, (int)std::floor(xr));
+        if( lo <= hi ) {
+            emit(lo, hi, y);
+        }
+    }
+}
+
+/**
+ * Draws the line's pixels within clip into fb_data via integer Bresenham.
+ *
+ * The parameter range is clipped first, hence only visible pixels are stepped
+ * and exactly the pixels of the unclipped line within clip are set.
+ * Returns the box of written pixels.
+ */
+static pixel::fb_region_t draw_line_clipped(const pixel::fb_region_t& clip, int x1, int y1, int x2, int y2, const uint32_t color) noexcept {
+    using namespace pixel;
+    fb_region_t written;
+    if( ( x1 < clip.x1 && x2 < clip.x1 ) || ( x1 > clip.x2 && x2 > clip.x2 ) ||
+        ( y1 < clip.y1 && y2 < clip.y1 ) || ( y1 > clip.y2 && y2 > clip.y2 ) ) {
+        return written;
+    }
+    // Line along major axis a and minor axis b, with pixel i in [0..da] at
+    // a = a1 + sa * i and b = b1 + sb * o(i), where o(i) = floor( ( 2*i*db + da ) / ( 2*da ) ).
+    const bool x_major = std::abs(x2 - x1) >= std::abs(y2 - y1);
+    const int a1 = x_major ? x1 : y1, a2 = x_major ? x2 : y2;
+    const int b1 = x_major ? y1 : x1, b2 = x_major ? y2 : x2;
+    const int a_lo = x_major ? clip.x1 : clip.y1, a_hi = x_major ? clip.x2 : clip.y2;
+    const int b_lo = x_major ? clip.y1 : clip.x1, b_hi = x_major ? clip.y2 : clip.x2;
+    const int64_t da = std::abs(a2 - a1), db = std::abs(b2 - b1);
+    const int sa = a2 >= a1 ? 1 : -1, sb = b2 >= b1 ? 1 : -1;
+
+    // Clip parameter range i against the major axis ..
+    int64_t i0 = 0, i1 = da;
+    if( sa > 0 ) {
+        i0 = std::max<int64_t>(i0, a_lo - a1);
+        i1 = std::min<int64_t>(i1, a_hi - a1);
+    } else {
+        i0 = std::max<int64_t>(i0, a1 - a_hi);
+        i1 = std::min<int64_t>(i1, a1 - a_lo);
+    }
+    // .. and the minor axis, i.e. o_lo <= o(i) <= o_hi
+    if( db > 0 ) {
+        const int64_t o_lo = sb > 0 ? b_lo - b1 : b1 - b_hi;
+        const int64_t o_hi = sb > 0 ? b_hi - b1 : b1 - b_lo;
+        const int64_t d2a = 2 * da, d2b = 2 * db;
+        // o(i) >= o_lo <=> i >= ceil( ( 2*da*o_lo - da ) / ( 2*db ) )
+        const int64_t n_lo = d2a * o_lo - da;
+        i0 = std::max<int64_t>(i0, n_lo > 0 ? ( n_lo + d2b - 1 ) / d2b : -( -n_lo / d2b ));
+        // o(i) <= o_hi <=> i <= floor( ( 2*da*(o_hi+1) - da - 1 ) / ( 2*db ) )
+        const int64_t n_hi = d2a * ( o_hi + 1 ) - da - 1;
+        i1 = std::min<int64_t>(i1, n_hi >= 0 ? n_hi / d2b : -( ( -n_hi + d2b - 1 ) / d2b ));
+    } else if( b1 < b_lo || b1 > b_hi ) {
+        return written;
+    }
+    if( i0 > i1 ) {
+        return written;
+    }
+    // Setup incremental stepping at i0, num = ( 2*i0*db + da ) mod 2*da
+    const int64_t d2a = 2 * std::max<int64_t>(1, da);
+    const int64_t n0 = 2 * i0 * db + da;
+    int64_t num = n0 % d2a;
+    const int a_0 = a1 + sa * (int)i0;
+    const int b_0 = b1 + sb * (int)( n0 / d2a );
+    const int x_0 = x_major ? a_0 : b_0, y_0 = x_major ? b_0 : a_0;
+    const ptrdiff_t step_a = x_major ? sa : sa * ptrdiff_t(fb_stride);
+    const ptrdiff_t step_b = x_major ? sb * ptrdiff_t(fb_stride) : sb;
+    uint32_t* p = fb_data + ( ptrdiff_t(y_0) * fb_stride + x_0 );
+    for(int64_t i = i0; i <= i1; ++i) {
+        *p = color;
+        p += step_a;
+        num += 2 * db;
+        if( num >= d2a ) {
+            num -= d2a;
+            p += step_b;
+        }
+    }
+    const int64_t n1 = 2 * i1 * db + da;
+    const int a_1 = a1 + sa * (int)i1;
+    const int b_1 = b1 + sb * (int)( n1 / d2a );
+    const int x_1 = x_major ? a_1 : b_1, y_1 = x_major ? b_1 : a_1;
+    written.add(std::min(x_0, x_1), std::min(y_0, y_1), std::max(x_0, x_1), std::max(y_0, y_1));
+    return written;
+}
+
+//
+// Tiled rasterizer
+//
+
+bool pixel::fb_tiles_pending = false;
+
+namespace {
+    /** Recorded software draw command of the tiled rasterizer */
+    struct tile_cmd_t {
+        enum class type_t : uint8_t { triangle, disk, line };
+        type_t type;
+        bool box;
+        uint32_t color;
+        /** covered framebuffer box, clipped */
+        pixel::fb_region_t bounds;
+        /** triangle: x1, y1, x2, y2, x3, y3; disk: cx, cy, r_out, r_excl; line: x1, y1, x2, y2 */
+        int v[6];
+    };
+
+    /** Worker pool running one job per index, the calling thread participates. */
+    class tile_pool_t {
+        private:
+            std::vector<std::thread> m_threads;
+            std::mutex m_mtx;
+            std::condition_variable m_cv_work;
+            std::condition_variable m_cv_done;
+            uint64_t m_generation = 0;
+            bool m_stop = false;
+            size_t m_busy = 0;
+            std::atomic<size_t> m_next = 0;
+            size_t m_count = 0;
+            std::function<void(size_t)> m_job;
+
+            void work() noexcept {
+                for(size_t i = m_next++; i < m_count; i = m_next++) {
+                    m_job(i);
+                }
+            }
+            void worker() noexcept {
+                uint64_t generation = 0;
+                while( true ) {
+                    {
+                        std::unique_lock<std::mutex> lock(m_mtx);
+                        m_cv_work.wait(lock, [&]{ return m_stop || m_generation != generation; });
+                        if( m_stop ) {
+                            return;
+                        }
+                        generation = m_generation;
+                    }
+                    work();
+                    {
+                        std::unique_lock<std::mutex> lock(m_mtx);
+                        if( 0 == --m_busy ) {
+                            m_cv_done.notify_all();
+                        }
+                    }
+                }
+            }
+
+        public:
+            ~tile_pool_t() noexcept { resize(0); }
+
+            size_t size() const noexcept { return m_threads.size(); }
+
+            void resize(const size_t n) noexcept {
+                if( n == m_threads.size() ) {
+                    return;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(m_mtx);
+                    m_stop = true;
+                }
+                m_cv_work.notify_all();
+                for(std::thread& t : m_threads) {
+                    t.join();
+                }
+                m_threads.clear();
+                m_stop = false;
+                for(size_t i=0; i<n; ++i) {
+                    m_threads.emplace_back(&tile_pool_t::worker, this);
+                }
+            }
+
+            void run(const size_t count, std::function<void(size_t)> job) noexcept {
+                m_job = std::move(job);
+                m_count = count;
+                m_next = 0;
+                {
+                    std::unique_lock<std::mutex> lock(m_mtx);
+                    m_busy = m_threads.size();
+                    ++m_generation;
+                }
+                m_cv_work.notify_all();
+                work();
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cv_done.wait(lock, [&]{ return 0 == m_busy; });
+            }
+    };
+
+    constexpr int tile_size = 64;
+    constexpr size_t tile_max_cmds = 1U << 16;
+
+    unsigned int tile_threads = 0;
+    tile_pool_t tile_pool;
+    std::vector<tile_cmd_t> tile_cmds;
+    std::vector<std::vector<uint32_t>> tile_bins;
+    std::vector<uint32_t> tile_active;
+
+    void tile_add(tile_cmd_t&& cmd) noexcept {
+        using namespace pixel;
+        fb_region_t& b = cmd.bounds;
+        b.x1 = std::max(0, b.x1); b.y1 = std::max(0, b.y1);
+        b.x2 = std::min(fb_max_x, b.x2); b.y2 = std::min(fb_max_y, b.y2);
+        if( b.x1 > b.x2 || b.y1 > b.y2 ) {
+            return;
+        }
+        fb_dirty.add(b);
+        tile_cmds.push_back(cmd);
+        fb_tiles_pending = true;
+        if( tile_cmds.size() >= tile_max_cmds ) {
+            fb_tiles_flush();
+        }
+    }
+
+    void tile_draw(const tile_cmd_t& cmd, const pixel::fb_region_t& clip) noexcept {
+        using namespace pixel;
+        const uint32_t color = cmd.color;
+        auto fill = [color](const int x1, const int x2, const int y) {
+            kernel::fill(fb_data + ( y * fb_stride + x1 ), size_t(x2 - x1 + 1), color);
+        };
+        const int* v = cmd.v;
+        switch( cmd.type ) {
+            case tile_cmd_t::type_t::triangle:
+                triangle_spans(clip, v[0], v[1], v[2], v[3], v[4], v[5], fill);
+                break;
+            case tile_cmd_t::type_t::disk:
+                disk_spans(clip, v[0], v[1], v[2], v[3], cmd.box, fill);
+                break;
+            case tile_cmd_t::type_t::line:
+                draw_line_clipped(clip, v[0], v[1], v[2], v[3], color);
+                break;
+        }
+    }
+}
+
+void pixel::set_fb_tiled(unsigned int threads) noexcept {
+    fb_tiles_flush();
+    tile_threads = threads;
+    tile_pool.resize( threads > 1 ? threads - 1 : 0 );
+}
+
+unsigned int pixel::fb_tiled() noexcept { return tile_threads; }
+
+void pixel::fb_tiles_add_triangle(int x1, int y1, int x2, int y2, int x3, int y3) noexcept {
+    tile_cmd_t cmd { tile_cmd_t::type_t::triangle, false, draw_color, fb_region_t(), { x1, y1, x2, y2, x3, y3 } };
+    cmd.bounds.add(std::min({x1, x2, x3}), std::min({y1, y2, y3}), std::max({x1, x2, x3}), std::max({y1, y2, y3}));
+    tile_add(std::move(cmd));
+}
+
+void pixel::fb_tiles_add_disk(int cx, int cy, int r_out, int r_excl, bool box) noexcept {
+    if( 0 > r_out ) {
+        return;
+    }
+    tile_cmd_t cmd { tile_cmd_t::type_t::disk, box, draw_color, fb_region_t(), { cx, cy, r_out, r_excl, 0, 0 } };
+    cmd.bounds.add(cx - r_out, cy - r_out, cx + r_out, cy + r_out);
+    tile_add(std::move(cmd));
+}
+
+void pixel::fb_tiles_add_line(int x1, int y1, int x2, int y2) noexcept {
+    tile_cmd_t cmd { tile_cmd_t::type_t::line, false, draw_color, fb_region_t(), { x1, y1, x2, y2, 0, 0 } };
+    cmd.bounds.add(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2));
+    tile_add(std::move(cmd));
+}
+
+void pixel::fb_tiles_flush() noexcept {
+    if( !fb_tiles_pending ) {
+        return;
+    }
+    fb_tiles_pending = false;
+    const int tiles_x = ( fb_width + tile_size - 1 ) / tile_size;
+    const int tiles_y = ( fb_height + tile_size - 1 ) / tile_size;
+    const size_t tile_count = size_t(tiles_x) * size_t(tiles_y);
+    if( tile_bins.size() != tile_count ) {
+        tile_bins.clear();
+        tile_bins.resize(tile_count);
+    }
+    // bin commands in submission order, preserving the draw order within each tile
+    tile_active.clear();
+    for(size_t i=0; i<tile_cmds.size(); ++i) {
+        const fb_region_t& b = tile_cmds[i].bounds;
+        for(int ty = b.y1 / tile_size; ty <= b.y2 / tile_size; ++ty) {
+            for(int tx = b.x1 / tile_size; tx <= b.x2 / tile_size; ++tx) {
+                const uint32_t t = uint32_t(ty * tiles_x + tx);
+                if( tile_bins[t].empty() ) {
+                    tile_active.push_back(t);
+                }
+                tile_bins[t].push_back(uint32_t(i));
+            }
+        }
+    }
+    // each tile is rasterized by exactly one thread
+    tile_pool.run(tile_active.size(), [tiles_x](const size_t k) {
+        const uint32_t t = tile_active[k];
+        fb_region_t clip;
+        clip.x1 = int(t % uint32_t(tiles_x)) * tile_size;
+        clip.y1 = int(t / uint32_t(tiles_x)) * tile_size;
+        clip.x2 = std::min(fb_max_x, clip.x1 + tile_size - 1);
+        clip.y2 = std::min(fb_max_y, clip.y1 + tile_size - 1);
+        for(const uint32_t i : tile_bins[t]) {
+            tile_draw(tile_cmds[i], clip);
+        }
+        tile_bins[t].clear();
+    });
+    tile_cmds.clear();
+}
+
+void pixel::draw_line_fbcoord(int x1, int y1, int x2, int y2) noexcept {
+    if( use_subsys_primitives_val ) {
+        subsys_draw_line(x1, y1, x2, y2);
+    } else if( 0 < fb_tiled() ) {
+        fb_tiles_add_line(x1, y1, x2, y2);
+    } else {
+        fb_region_t clip;
+        clip.set_all();
+        fb_dirty.add( draw_line_clipped(clip, x1, y1, x2, y2, draw_color) );
+    }
+}
+
+void pixel::draw_line_aa_fbcoord(float x1, float y1, float x2, float y2) noexcept {
+    if( use_subsys_primitives_val ) {
+        draw_line_fbcoord(jau::round_to_int(x1), jau::round_to_int(y1), jau::round_to_int(x2), jau::round_to_int(y2));
+        return;
+    }
+    // Liang-Barsky clipping against the framebuffer extended by one pixel for partial coverage
+    {
+        const float dx = x2 - x1, dy = y2 - y1;
+        const float p[4] = { -dx, dx, -dy, dy };
+        const float q[4] = { x1 + 1.0f, (float)fb_max_x + 1.0f - x1, y1 + 1.0f, (float)fb_max_y + 1.0f - y1 };
+        float t0 = 0.0f, t1 = 1.0f;
+        for(int k=0; k<4; ++k) {
+            if( jau::is_zero(p[k]) ) {
+                if( q[k] < 0.0f ) {
+                    return;
+                }
+            } else {
+                const float t = q[k] / p[k];
+                if( p[k] < 0.0f ) {
+                    t0 = std::max(t0, t);
+                } else {
+                    t1 = std::min(t1, t);
+                }
+            }
+        }
+        if( t0 > t1 ) {
+            return;
+        }
+        x2 = x1 + t1 * dx; y2 = y1 + t1 * dy;
+        x1 = x1 + t0 * dx; y1 = y1 + t0 * dy;
+    }
+    if( fb_tiles_pending ) {
+        fb_tiles_flush();
+    }
+    const uint32_t rgb = draw_color & 0x00ffffffU;
+    const float alpha = (float)( draw_color >> 24 );
+    auto plot = [&](const int x, const int y, const float coverage) noexcept {
+        if( 0 <= x && x <= fb_max_x && 0 <= y && y <= fb_max_y ) {
+            const uint32_t a = (uint32_t)jau::round_to_int( alpha * coverage );
+            kernel::blend(fb_data + ( y * fb_stride + x ), 1, rgb | ( a << 24 ));
+            fb_dirty.add(x, y);
+        }
+    };
+    const bool steep = std::abs(y2 - y1) > std::abs(x2 - x1);
+    if( steep ) {
+        std::swap(x1, y1);
+        std::swap(x2, y2);
+    }
+    if( x1 > x2 ) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+    const float dx = x2 - x1;
+    const float gradient = jau::is_zero(dx) ? 1.0f : ( y2 - y1 ) / dx;
+    auto plot2 = [&](const int a, const float b, const float coverage) noexcept {
+        const int b_i = (int)std::floor(b);
+        const float f = b - (float)b_i;
+        if( steep ) {
+            plot(b_i, a, ( 1.0f - f ) * coverage);
+            plot(b_i + 1, a, f * coverage);
+        } else {
+            plot(a, b_i, ( 1.0f - f ) * coverage);
+            plot(a, b_i + 1, f * coverage);
+        }
+    };
+    // end points with horizontal coverage
+    const int a_s = jau::round_to_int(x1);
+    const int a_e = jau::round_to_int(x2);
+    const float b_s = y1 + gradient * ( (float)a_s - x1 );
+    const float b_e = y2 + gradient * ( (float)a_e - x2 );
+    plot2(a_s, b_s, 1.0f - ( x1 + 0.5f - (float)a_s ));
+    if( a_e != a_s ) {
+        plot2(a_e, b_e, x2 + 0.5f - (float)a_e);
+    }
+    float b = b_s + gradient;
+    for(int a = a_s + 1; a < a_e; ++a, b += gradient) {
+        plot2(a, b, 1.0f);
+    }
+}
+
+void pixel::draw_spans_fbcoord(const fb_span_t* spans, size_t count) noexcept {
+    if( use_subsys_primitives_val ) {
+        subsys_draw_spans(spans, count);
+    } else {
+        for(size_t i=0; i<count; ++i) {
+            draw_span_fbcoord(spans[i].x1, spans[i].x2, spans[i].y);
+        }
+    }
+}
+
+void pixel::fill_triangle_fbcoord(int x1, int y1, int x2, int y2, int x3, int y3) noexcept {
+    if( use_subsys_primitives_val ) {
+        const fb_vertex_t v[] = { { (float)x1 + 0.5f, (float)y1 + 0.5f },
+                                  { (float)x2 + 0.5f, (float)y2 + 0.5f },
+                                  { (float)x3 + 0.5f, (float)y3 + 0.5f } };
+        subsys_fill_triangles(v, 3);
+        return;
+    }
+    if( 0 < fb_tiled() ) {
+        fb_tiles_add_triangle(x1, y1, x2, y2, x3, y3);
+        return;
+    }
+    fb_region_t clip;
+    clip.set_all();
+    static std::vector<fb_span_t> spans;
+    spans.clear();
+    triangle_spans(clip, x1, y1, x2, y2, x3, y3, [](const int lo, const int hi, const int y) {
+        spans.push_back( { lo, hi, y } );
+    });
+    draw_spans_fbcoord(spans.data(), spans.size());
+}
+
+void pixel::fill_quad_fbcoord(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4) noexcept {
+    if( use_subsys_primitives_val ) {
+        const fb_vertex_t a { (float)x1 + 0.5f, (float)y1 + 0.5f };
+        const fb_vertex_t b { (float)x2 + 0.5f, (float)y2 + 0.5f };
+        const fb_vertex_t c { (float)x3 + 0.5f, (float)y3 + 0.5f };
+        const fb_vertex_t d { (float)x4 + 0.5f, (float)y4 + 0.5f };
+        const fb_vertex_t v[] = { a, b, c, a, c, d };
+        subsys_fill_triangles(v, 6);
+    } else {
+        fill_triangle_fbcoord(x1, y1, x2, y2, x3, y3);
+        fill_triangle_fbcoord(x1, y1, x3, y3, x4, y4);
+    }
+}
+
+namespace {
+    /** Draws the disk spans via draw_spans_fbcoord() or records them for the tiled rasterizer. */
+    void draw_disk_spans(const int cx, const int cy, const int r_out, const int r_excl, const bool box) noexcept {
+        using namespace pixel;
+        if( 0 < fb_tiled() ) {
+            fb_tiles_add_disk(cx, cy, r_out, r_excl, box);
+            return;
+        }
+        fb_region_t clip;
+        clip.set_all();
+        static std::vector<fb_span_t> spans;
+        spans.clear();
+        disk_spans(clip, cx, cy, r_out, r_excl, box, [](const int lo, const int hi, const int y) {
+            spans.push_back( { lo, hi, y } );
+        });
+        draw_spans_fbcoord(spans.data(), spans.size());
+    }
+
+    /** Returns the number of segments to tessellate a circle of radius r, keeping the chord error below 1/4 pixel. */
+    int circle_segments(const float r) noexcept {
+        return std::clamp((int)std::ceil( (float)M_PI * std::sqrt( 2.0f * r ) ), 8, 256);
+    }
+
+    /**
+     * Submits the ring between radius r_out and r_in around the center of pixel cx/cy as one triangle list,
+     * or the disk of radius r_out if r_in <= 0.
+     */
+    void fill_ring_geometry(const int cx, const int cy, const float r_out, const float r_in) noexcept {
+        using namespace pixel;
+        if( cx + r_out < 0 || cx - r_out > fb_max_x + 1 || cy + r_out < 0 || cy - r_out > fb_max_y + 1 ) {
+            return;
+        }
+        const float fx = (float)cx + 0.5f;
+        const float fy = (float)cy + 0.5f;
+        const bool disk = 0.0f >= r_in;
+        const int n = circle_segments(r_out);
+        const float a_step = 2.0f * (float)M_PI / (float)n;
+
+        static std::vector<fb_vertex_t> verts;
+        verts.clear();
+        float c0 = 1.0f, s0 = 0.0f;
+        for(int i=1; i<=n; ++i) {
+            const float c1 = i < n ? std::cos( a_step * (float)i ) : 1.0f;
+            const float s1 = i < n ? std::sin( a_step * (float)i ) : 0.0f;
+            const fb_vertex_t o0 { fx + c0 * r_out, fy + s0 * r_out };
+            const fb_vertex_t o1 { fx + c1 * r_out, fy + s1 * r_out };
+            if( disk ) {
+                verts.push_back( { fx, fy } );
+                verts.push_back( o0 );
+                verts.push_back( o1 );
+            } else {
+                const fb_vertex_t i0 { fx + c0 * r_in, fy + s0 * r_in };
+                const fb_vertex_t i1 { fx + c1 * r_in, fy + s1 * r_in };
+                verts.push_back( o0 );
+                verts.push_back( o1 );
+                verts.push_back( i1 );
+                verts.push_back( o0 );
+                verts.push_back( i1 );
+                verts.push_back( i0 );
+            }
+            c0 = c1;
+            s0 = s1;
+        }
+        subsys_fill_triangles(verts.data(), verts.size());
+    }
+}
+
+void pixel::fill_disk_fbcoord(int cx, int cy, int r) noexcept {
+    if( use_subsys_primitives_val ) {
+        if( 0 <= r ) {
+            fill_ring_geometry(cx, cy, (float)r + 0.5f, 0.0f);
+        }
+    } else {
+        draw_disk_spans(cx, cy, r, -1, false);
+    }
+}
+
+void pixel::draw_ring_fbcoord(int cx, int cy, int r_outer, int r_inner) noexcept {
+    if( use_subsys_primitives_val && r_outer > r_inner ) {
+        fill_ring_geometry(cx, cy, (float)r_outer + 0.5f, (float)r_inner - 0.5f);
+    } else {
+        draw_disk_spans(cx, cy, r_outer, r_inner - 1, false);
+    }
+}
+
+void pixel::fill_disk_inverted_fbcoord(int cx, int cy, int r, int r_box) noexcept {
+    draw_disk_spans(cx, cy, r_box, r, true);
+}
+
 //
 // Bitmap
 //
@@ -132,6 +855,15 @@ void pixel::bitmap_t::put(const f2::aabbox_t& box, uint32_t abgr) noexcept {
     const uint32_t y1 = std::max<uint32_t>(0, floor_to_uint32(box.bl.y));
     const uint32_t x2 = std::min<uint32_t>(width, ceil_to_uint32(box.tr.x));
     const uint32_t y2 = std::min<uint32_t>(height, ceil_to_uint32(box.tr.y));
+    if( x1 >= x2 || y1 >= y2 ) {
+        return;
+    }
+    if( 4 == bpp && 0 == stride % 4 ) {
+        // rows are stored bottom-up, hence y2 - 1 is the lowest row in memory
+        uint32_t * const p = std::bit_cast<uint32_t *>(m_pixels + static_cast<size_t>((height - y2) * stride) + static_cast<size_t>(x1 * bpp));
+        kernel::fill_rect(p, stride / 4, x2 - x1, y2 - y1, abgr);
+        return;
+    }
     for(uint32_t y=y1; y<y2; ++y) {
         for(uint32_t x=x1; x<x2; ++x) {
             uint32_t * const target_pixel = std::bit_cast<uint32_t *>(m_pixels + static_cast<size_t>((height - y - 1) * stride) + static_cast<size_t>(x * bpp));
@@ -148,6 +880,14 @@ bool pixel::bitmap_t::equals(const f2::aabbox_t& box, uint32_t abgr) noexcept {
     const uint32_t y1 = std::max<uint32_t>(0, floor_to_uint32(box.bl.y));
     const uint32_t x2 = std::min<uint32_t>(width, ceil_to_uint32(box.tr.x));
     const uint32_t y2 = std::min<uint32_t>(height, ceil_to_uint32(box.tr.y));
+    if( x1 >= x2 || y1 >= y2 ) {
+        return true;
+    }
+    if( 4 == bpp && 0 == stride % 4 ) {
+        // rows are stored bottom-up, hence y2 - 1 is the lowest row in memory
+        const uint32_t * const p = std::bit_cast<uint32_t *>(m_pixels + static_cast<size_t>((height - y2) * stride) + static_cast<size_t>(x1 * bpp));
+        return kernel::equals_rect(p, stride / 4, x2 - x1, y2 - y1, abgr);
+    }
     for(uint32_t y=y1; y<y2; ++y) {
         for(uint32_t x=x1; x<x2; ++x) {
             const uint32_t * const target_pixel = std::bit_cast<uint32_t *>(m_pixels + static_cast<size_t>((height - y - 1) * stride) + static_cast<size_t>(x * bpp));
@@ -159,6 +899,194 @@ bool pixel::bitmap_t::equals(const f2::aabbox_t& box, uint32_t abgr) noexcept {
     return true;
 }
 
+size_t pixel::bitmap_t::swap_palette(const std::vector<std::pair<uint32_t, uint32_t>>& palette) noexcept {
+    if(!m_pixels || 4 != bpp || palette.empty() ) {
+        return 0;
+    }
+    size_t count = 0;
+    for(uint32_t y=0; y<height; ++y) {
+        uint32_t * const row = std::bit_cast<uint32_t *>(m_pixels + static_cast<size_t>(y * stride));
+        for(uint32_t x=0; x<width; ++x) {
+            const uint32_t abgr = row[x];
+            // sprite palettes are small, a linear scan beats hashing
+            for(const std::pair<uint32_t, uint32_t>& e : palette) {
+                if( abgr == e.first ) {
+                    row[x] = e.second;
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+//
+// Software sprite blitter
+//
+
+/** Returns the ARGB8888 value of given ABGR8888 value */
+static constexpr uint32_t abgr_to_argb(const uint32_t v) noexcept {
+    return ( v & 0xff00ff00U ) | ( ( v >> 16 ) & 0xffU ) | ( ( v & 0xffU ) << 16 );
+}
+
+/**
+ * Splits a row of ARGB8888 pixel into spans of visible pixels per blit_mode_t, calling emit(x, len, opaque) for each.
+ */
+template<typename Emit>
+static void blit_row_spans(const uint32_t* row, const int width, const pixel::blit_mode_t mode, const uint32_t key_argb, Emit emit) noexcept {
+    if( pixel::blit_mode_t::copy == mode ) {
+        emit(0, width, true);
+        return;
+    }
+    int x = 0;
+    while( x < width ) {
+        // kind: 0 transparent, 1 opaque, 2 translucent
+        auto kind = [&](const uint32_t v) -> int {
+            if( pixel::blit_mode_t::color_key == mode ) {
+                return key_argb == v ? 0 : 1;
+            }
+            const uint32_t a = v >> 24;
+            return 0 == a ? 0 : ( 255 == a ? 1 : 2 );
+        };
+        const int k = kind(row[x]);
+        int x2 = x + 1;
+        while( x2 < width && kind(row[x2]) == k ) {
+            ++x2;
+        }
+        if( 0 != k ) {
+            emit(x, x2 - x, 1 == k);
+        }
+        x = x2;
+    }
+}
+
+/** Scaled source pixel of a clipped span row */
+static std::vector<uint32_t> blit_scratch;
+
+/**
+ * Writes a span of len ARGB8888 source pixel with its top-left at fb_x/fb_y into the framebuffer,
+ * scaled to scale x scale blocks and clipped. Returns the written region.
+ */
+static void blit_span(const uint32_t* src, const int len, const bool opaque, const int fb_x, const int fb_y, const int scale, pixel::fb_region_t& written) noexcept {
+    const int x1 = std::max(0, fb_x);
+    const int x2 = std::min(pixel::fb_max_x, fb_x + len * scale - 1);
+    const int y1 = std::max(0, fb_y);
+    const int y2 = std::min(pixel::fb_max_y, fb_y + scale - 1);
+    if( x1 > x2 || y1 > y2 ) {
+        return;
+    }
+    const size_t n = size_t(x2 - x1 + 1);
+    const uint32_t* row;
+    if( 1 == scale ) {
+        row = src + ( x1 - fb_x );
+    } else {
+        blit_scratch.resize(n);
+        for(int x=x1; x<=x2; ++x) {
+            blit_scratch[size_t(x - x1)] = src[( x - fb_x ) / scale];
+        }
+        row = blit_scratch.data();
+    }
+    for(int y=y1; y<=y2; ++y) {
+        uint32_t* dst = pixel::fb_data + ( y * pixel::fb_stride + x1 );
+        if( opaque ) {
+            std::memcpy(dst, row, n * sizeof(uint32_t));
+        } else {
+            pixel::kernel::blend_over(dst, row, n);
+        }
+    }
+    written.add(x1, y1, x2, y2);
+}
+
+/** Returns false if nothing of a width x height sprite at fb_x/fb_y is visible, otherwise flushes pending tiles */
+static bool blit_prepare(const uint32_t width, const uint32_t height, const int fb_x, const int fb_y, const int scale) noexcept {
+    if( nullptr == pixel::fb_data || 0 == width || 0 == height || 0 >= scale ||
+        fb_x > pixel::fb_max_x || fb_y > pixel::fb_max_y ||
+        fb_x + int(width) * scale <= 0 || fb_y + int(height) * scale <= 0 )
+    {
+        return false;
+    }
+    if( pixel::fb_tiles_pending ) {
+        pixel::fb_tiles_flush();
+    }
+    return true;
+}
+
+void pixel::blit_fbcoord(const bitmap_t& bmp, int fb_x, int fb_y, int scale, blit_mode_t mode, uint32_t color_key) noexcept {
+    const uint8_t* pixels = bmp.pixels();
+    if( nullptr == pixels || 4 != bmp.bpp || !blit_prepare(bmp.width, bmp.height, fb_x, fb_y, scale) ) {
+        return;
+    }
+    // visible source columns and rows
+    const int sx1 = std::max(0, -fb_x / scale);
+    const int sx2 = std::min(int(bmp.width) - 1, ( fb_max_x - fb_x ) / scale);
+    const int sy1 = std::max(0, -fb_y / scale);
+    const int sy2 = std::min(int(bmp.height) - 1, ( fb_max_y - fb_y ) / scale);
+    const uint32_t key_argb = abgr_to_argb(color_key);
+    static std::vector<uint32_t> row;
+    row.resize(size_t(sx2 - sx1 + 1));
+    fb_region_t written;
+    for(int sy=sy1; sy<=sy2; ++sy) {
+        // memory rows are top-down
+        const uint32_t* src = std::bit_cast<const uint32_t*>(pixels + static_cast<size_t>(sy) * bmp.stride) + sx1;
+        for(size_t i=0; i<row.size(); ++i) {
+            row[i] = abgr_to_argb(src[i]);
+        }
+        const int dy = fb_y + sy * scale;
+        blit_row_spans(row.data(), int(row.size()), mode, key_argb, [&](const int x, const int len, const bool opaque) {
+            blit_span(row.data() + x, len, opaque, fb_x + ( sx1 + x ) * scale, dy, scale, written);
+        });
+    }
+    fb_dirty.add(written);
+}
+
+pixel::rle_sprite_t::rle_sprite_t(const bitmap_t& bmp, blit_mode_t mode, uint32_t color_key) noexcept {
+    const uint8_t* src_pixels = bmp.pixels();
+    if( nullptr == src_pixels || 4 != bmp.bpp || bmp.width > 0xffffU ) {
+        rows.push_back(0);
+        return;
+    }
+    width = bmp.width;
+    height = bmp.height;
+    const uint32_t key_argb = abgr_to_argb(color_key);
+    std::vector<uint32_t> row(width);
+    rows.reserve(height + 1);
+    for(uint32_t y=0; y<height; ++y) {
+        rows.push_back(uint32_t(spans.size()));
+        const uint32_t* src = std::bit_cast<const uint32_t*>(src_pixels + static_cast<size_t>(y) * bmp.stride);
+        for(uint32_t x=0; x<width; ++x) {
+            row[x] = abgr_to_argb(src[x]);
+        }
+        blit_row_spans(row.data(), int(width), mode, key_argb, [&](const int x, const int len, const bool opaque) {
+            spans.push_back( span_t { .x=uint16_t(x), .len=uint16_t(len), .opaque=opaque, .offset=uint32_t(pixels.size()) } );
+            pixels.insert(pixels.end(), row.begin() + x, row.begin() + x + len);
+        });
+    }
+    rows.push_back(uint32_t(spans.size()));
+}
+
+std::string pixel::rle_sprite_t::toString() const noexcept {
+    return "rle_sprite["+std::to_string(width)+"x"+std::to_string(height)+", spans "+std::to_string(spans.size())+
+           ", pixels "+std::to_string(pixels.size())+" of "+std::to_string(size_t(width)*height)+", "+std::to_string(byte_size())+" bytes]";
+}
+
+void pixel::blit_fbcoord(const rle_sprite_t& sprite, int fb_x, int fb_y, int scale) noexcept {
+    if( !blit_prepare(sprite.width, sprite.height, fb_x, fb_y, scale) ) {
+        return;
+    }
+    const int sy1 = std::max(0, -fb_y / scale);
+    const int sy2 = std::min(int(sprite.height) - 1, ( fb_max_y - fb_y ) / scale);
+    fb_region_t written;
+    for(int sy=sy1; sy<=sy2; ++sy) {
+        const int dy = fb_y + sy * scale;
+        for(uint32_t i=sprite.rows[size_t(sy)]; i<sprite.rows[size_t(sy)+1]; ++i) {
+            const rle_sprite_t::span_t& sp = sprite.spans[i];
+            blit_span(sprite.pixels.data() + sp.offset, sp.len, sp.opaque, fb_x + sp.x * scale, dy, scale, written);
+        }
+    }
+    fb_dirty.add(written);
+}
+
 //
 // Texture
 //
@@ -233,7 +1161,7 @@ pixel::texture_ref pixel::add_sub_texture(const texture_ref& parent, uint32_t x_
 //
 
 pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::vector<texture_ref>& textures) noexcept
-: m_name( std::move(name) )
+: m_name( std::move(name) ), m_atlas(nullptr)
 {
     for(const texture_ref& t : textures) {
         m_textures.push_back( t->createShared() );
@@ -245,10 +1173,11 @@ pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::vec
 }
 
 pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::vector<const char*>& filenames) noexcept
-: m_name( std::move(name) )
+: m_name( std::move(name) ), m_atlas(nullptr)
 {
+    m_atlas = &default_tex_atlas();
     for(const char* fname : filenames) {
-        m_textures.push_back( std::make_shared<texture_t>(fname) );
+        m_subs.push_back( default_tex_atlas().add(fname) );
     }
     m_sec_per_atex = sec_per_atex;
     m_atex_sec_left = 0;
@@ -257,7 +1186,7 @@ pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::vec
 }
 
 pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::string& filename, int w, int h, int x_off) noexcept
-: m_name( std::move(name) )
+: m_name( std::move(name) ), m_atlas(nullptr)
 {
     add_sub_textures(m_textures, filename, w, h, x_off);
     m_sec_per_atex = sec_per_atex;
@@ -268,7 +1197,7 @@ pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const std::str
 
 pixel::animtex_t::animtex_t(std::string name, float sec_per_atex, const texture_ref& global_texture,
                             int x_off, int y_off, int w, int h, const std::vector<tex_sub_coord_t>& tex_positions) noexcept
-: m_name(std::move(name))
+: m_name(std::move(name)), m_atlas(nullptr)
 {
     add_sub_textures(m_textures, global_texture, x_off, y_off, w, h, tex_positions);
     m_sec_per_atex = sec_per_atex;
@@ -302,8 +1231,8 @@ void pixel::animtex_t::tick(const float dt) noexcept {
 
 void pixel::animtex_t::next() noexcept {
     m_atex_sec_left = m_sec_per_atex;
-    if( m_textures.size() > 0 ) {
-        m_animation_index = ( m_animation_index + 1 ) % m_textures.size();
+    if( size() > 0 ) {
+        m_animation_index = ( m_animation_index + 1 ) % size();
     } else {
         m_animation_index = 0;
     }
@@ -314,10 +1243,21 @@ std::string pixel::animtex_t::toString() const noexcept {
     std::string tex_s = nullptr != tex ? tex->toString() : "null";
     return m_name+"[anim "+std::to_string(m_atex_sec_left)+"/"+std::to_string(m_sec_per_atex)+
             " s, paused "+std::to_string(m_paused)+", idx "+std::to_string(m_animation_index)+
-            "/"+std::to_string(m_textures.size())+
+            "/"+std::to_string(size())+
             ", textures["+tex_s+"]]";
 }
 
+/** Places the text texture, rendered at native font_height_usr, at line lineno below top-left tl */
+static void place_text(pixel::texture_t& tex, const pixel::f2::point_t& tl, const int lineno, const int font_height_usr) noexcept {
+    tex.dest_sx = 1.0f;
+    tex.dest_sy = 1.0f;
+    tex.dest_x = pixel::cart_coord.to_fb_x(tl.x);
+    const float fh2 = pixel::cart_coord.from_fb_dy(font_height_usr);
+    tex.dest_y = pixel::cart_coord.to_fb_y(
+            tl.y - std::round((float)lineno * fh2 * 1.15f));
+//          tl.y - std::round((float)lineno * tex.dest_sy * (float)font_height * 1.15f));
+}
+
 pixel::texture_ref pixel::make_text(const char* format, ...) noexcept {
     va_list args;
     va_start (args, format);
@@ -340,14 +1280,140 @@ pixel::texture_ref pixel::make_text(const pixel::f2::point_t& tl, const int line
                                     const pixel::f4::vec_t& color, const int font_height_usr,
                                     const std::string& text) noexcept {
     pixel::set_pixel_color4f(color.x, color.y, color.z, color.w);
-    pixel::texture_ref tex = pixel::make_text(text.c_str());
-    tex->dest_sx = (float)font_height_usr / (float)font_height;
-    tex->dest_sy = (float)font_height_usr / (float)font_height;
-    tex->dest_x = pixel::cart_coord.to_fb_x(tl.x);
-    const float fh2 = pixel::cart_coord.from_fb_dy(font_height_usr);
-    tex->dest_y = pixel::cart_coord.to_fb_y(
-            tl.y - std::round((float)lineno * fh2 * 1.15f));
-//          tl.y - std::round((float)lineno * tex->dest_sy * (float)font_height * 1.15f));
+    pixel::texture_ref tex = pixel::make_text(font_height_usr, text);
+    place_text(*tex, tl, lineno, font_height_usr);
+    return tex;
+}
+
+//
+// Text label cache
+//
+
+namespace {
+    /** Text label cache key, referencing the text of its entry */
+    struct text_key_t {
+        uint64_t id;
+        uint32_t color;
+        int font_height;
+        std::string_view text;
+
+        bool operator==(const text_key_t& o) const noexcept {
+            return id == o.id && color == o.color && font_height == o.font_height && text == o.text;
+        }
+    };
+    struct text_key_hash_t {
+        size_t operator()(const text_key_t& k) const noexcept {
+            size_t h = std::hash<std::string_view>()(k.text);
+            h ^= size_t( k.id * 0x9e3779b97f4a7c15ULL ) + ( h << 6 ) + ( h >> 2 );
+            h ^= size_t( ( uint64_t(k.color) << 16 ) ^ uint64_t(k.font_height) ) + ( h << 6 ) + ( h >> 2 );
+            return h;
+        }
+    };
+    struct text_entry_t {
+        uint64_t id;
+        uint32_t color;
+        int font_height;
+        std::string text;
+        pixel::texture_ref tex;
+        size_t bytes;
+    };
+
+    /** LRU cache of text textures, most recently used first */
+    class text_cache_t {
+        private:
+            typedef std::list<text_entry_t> lru_t;
+            lru_t m_lru;
+            std::unordered_map<text_key_t, lru_t::iterator, text_key_hash_t> m_map;
+            size_t m_budget = 1U << 20;
+            pixel::text_cache_stats_t m_stats = { 0, 0, 0, 0, 0 };
+
+            static size_t byte_size(const text_entry_t& e) noexcept {
+                const pixel::texture_t& t = *e.tex;
+                const size_t pixels = t.atlas ? t.text_glyphs.capacity() * sizeof(pixel::text_glyph_t)
+                                                   : size_t(t.width) * t.height * t.bpp;
+                return sizeof(text_entry_t) + sizeof(pixel::texture_t) + e.text.capacity() + pixels;
+            }
+            void evict_to(const size_t budget) noexcept {
+                while( !m_lru.empty() && m_stats.bytes > budget ) {
+                    const text_entry_t& e = m_lru.back();
+                    m_map.erase( text_key_t { e.id, e.color, e.font_height, e.text } );
+                    m_stats.bytes -= e.bytes;
+                    m_lru.pop_back();
+                    ++m_stats.evictions;
+                }
+                m_stats.entries = m_lru.size();
+            }
+
+        public:
+            pixel::texture_ref get(const uint64_t id, const int font_size, const std::string& text) noexcept {
+                using namespace pixel;
+                const text_key_t key { id, draw_color, font_size, text };
+                auto it = m_map.find(key);
+                if( it != m_map.end() ) {
+                    m_lru.splice(m_lru.begin(), m_lru, it->second);
+                    ++m_stats.hits;
+                    return it->second->tex;
+                }
+                ++m_stats.misses;
+                texture_ref tex = make_text(font_size, text);
+                if( 0 == m_budget ) {
+                    return tex;
+                }
+                m_lru.push_front( text_entry_t { id, draw_color, font_size, text, tex, 0 } );
+                text_entry_t& e = m_lru.front();
+                e.bytes = byte_size(e);
+                m_stats.bytes += e.bytes;
+                m_map[ text_key_t { e.id, e.color, e.font_height, e.text } ] = m_lru.begin();
+                // keep the new entry even if it exceeds the budget alone
+                evict_to( std::max(m_budget, e.bytes) );
+                return tex;
+            }
+            void set_budget(const size_t bytes) noexcept { m_budget = bytes; evict_to(bytes); }
+            size_t budget() const noexcept { return m_budget; }
+            void clear() noexcept {
+                m_map.clear();
+                m_lru.clear();
+                m_stats.bytes = 0;
+                m_stats.entries = 0;
+            }
+            const pixel::text_cache_stats_t& stats() const noexcept { return m_stats; }
+    };
+    text_cache_t text_cache;
+}
+
+std::string pixel::text_cache_stats_t::toString() const noexcept {
+    const size_t lookups = hits + misses;
+    return "text_cache[hits "+std::to_string(hits)+", misses "+std::to_string(misses)+
+           " ("+std::to_string(0 < lookups ? 100.0 * double(hits) / double(lookups) : 0.0)+"% hits)"+
+           ", evictions "+std::to_string(evictions)+", entries "+std::to_string(entries)+
+           ", bytes "+std::to_string(bytes)+"]";
+}
+
+void pixel::set_text_cache_budget(size_t bytes) noexcept { text_cache.set_budget(bytes); }
+size_t pixel::text_cache_budget() noexcept { return text_cache.budget(); }
+pixel::text_cache_stats_t pixel::text_cache_stats() noexcept { return text_cache.stats(); }
+void pixel::clear_text_cache() noexcept { text_cache.clear(); }
+
+pixel::texture_ref pixel::make_text_cached(const uint64_t id, const std::string& text) noexcept {
+    return text_cache.get(id, font_height, text);
+}
+
+pixel::texture_ref pixel::make_text_cached(const uint64_t id, const pixel::f2::point_t& tl, const int lineno,
+                                           const pixel::f4::vec_t& color, const int font_height_usr,
+                                           const char* format, ...) noexcept {
+    va_list args;
+    va_start (args, format);
+    std::string s = to_stringva(format, args);
+    va_end (args);
+    return make_text_cached(id, tl, lineno, color, font_height_usr, s);
+}
+
+pixel::texture_ref pixel::make_text_cached(const uint64_t id, const pixel::f2::point_t& tl, const int lineno,
+                                           const pixel::f4::vec_t& color, const int font_height_usr,
+                                           const std::string& text) noexcept {
+    pixel::set_pixel_color4f(color.x, color.y, color.z, color.w);
+    pixel::texture_ref tex = text_cache.get(id, font_height_usr, text);
+    place_text(*tex, tl, lineno, font_height_usr);
     return tex;
 }
 
@@ -368,32 +1434,8 @@ void pixel::f2::lineseg_t::draw(const point_t& p0, const point_t& p1) noexcept {
         subsys_draw_line(cart_coord.to_fb_x( p0.x ), cart_coord.to_fb_y( p0.y ),
                          cart_coord.to_fb_x( p1.x ), cart_coord.to_fb_y( p1.y ));
     } else {
-        const int p0_x = cart_coord.to_fb_x( p0.x );
-        const int p0_y = fb_height - cart_coord.to_fb_y( p0.y );
-        const int p1_x = cart_coord.to_fb_x( p1.x );
-        const int p1_y = fb_height - cart_coord.to_fb_y( p1.y );
-        const int dx = p1_x - p0_x;
-        const int dy = p1_y - p0_y;
-        const int dx_abs = std::abs(dx);
-        const int dy_abs = std::abs(dy);
-        float p_x = (float)p0_x, p_y = (float)p0_y;
-        if( dy_abs > dx_abs ) {
-            const float a = (float)dx / (float)dy_abs; // [0..1), dy_abs > 0
-            const int step_h = dy / dy_abs; // +1 or -1
-            for(int i = 0; i <= dy_abs; ++i) {
-                pixel::set_pixel_fbcoord( (int)p_x, fb_height - (int)p_y );
-                p_y += (float)step_h; // = p0.y + i * step_h
-                p_x += a;
-            }
-        } else if( dx_abs > 0 ) {
-            const float a = (float)dy / (float)dx_abs; // [0..1], dx_abs > 0
-            const int step_w = dx / dx_abs; // +1 or -1
-            for(int i = 0; i <= dx_abs; ++i) {
-                pixel::set_pixel_fbcoord( (int)p_x, fb_height - (int)p_y );
-                p_x += (float)step_w; // = p0.x + i * step_w
-                p_y += a;
-            }
-        }
+        draw_line_fbcoord(cart_coord.to_fb_x( p0.x ), cart_coord.to_fb_y( p0.y ),
+                          cart_coord.to_fb_x( p1.x ), cart_coord.to_fb_y( p1.y ));
     }
 }
 
@@ -407,66 +1449,27 @@ void pixel::f2::aabbox_t::draw() const noexcept {
 }
 
 void pixel::f2::disk_t::draw(const bool filled) const noexcept {
-    const float x_ival = pixel::cart_coord.width() / (float)pixel::fb_width;
-    const float y_ival = pixel::cart_coord.height() / (float)pixel::fb_height;
-    const float ival2 = 1.0f*std::min(x_ival, y_ival);
-    const aabbox_t b = box();
-    for(float y=b.bl.y; y<=b.tr.y; y+=y_ival) {
-        for(float x=b.bl.x; x<=b.tr.x; x+=x_ival) {
-            const point_t p { x, y };
-            const float cp = center.dist(p);
-            if( ( filled && cp <= radius ) ||
-                ( !filled && std::abs(cp - radius) <= ival2 ) ) {
-                p.draw();
-            }
-        }
+    const int cx = cart_coord.to_fb_x( center.x );
+    const int cy = cart_coord.to_fb_y( center.y );
+    const int r = cart_coord.to_fb_dx( radius );
+    if( filled ) {
+        fill_disk_fbcoord(cx, cy, r);
+    } else {
+        draw_ring_fbcoord(cx, cy, r, r);
     }
 }
 
+void pixel::f2::disk_t::draw_with_thickness() const noexcept {
+    draw_ring_fbcoord(cart_coord.to_fb_x( center.x ), cart_coord.to_fb_y( center.y ),
+                      cart_coord.to_fb_dx( radius ), cart_coord.to_fb_dx( radius - thickness ));
+}
+
 void pixel::f2::rect_t::draw(const bool filled) const noexcept {
     if(filled) {
-        constexpr bool debug = false;
-        vec_t ac = m_bl - m_tl;
-        ac.normalize();
-        vec_t vunit_per_pixel((float)pixel::cart_coord.from_fb_dx( 1 ), (float)pixel::cart_coord.from_fb_dy( 1 ));
-        if( debug ) {
-            printf("unit_per_pixel real %s\n", vunit_per_pixel.toString().c_str());
-        }
-        vunit_per_pixel.normalize();
-        float unit_per_pixel = vunit_per_pixel.length();
-        /**
-         * Problem mit rotation, wo step breite und linien-loop zu luecken fuehrt!
-         */
-        vec_t step = ac * unit_per_pixel * 1.0f;
-        vec_t i(m_tl), j(m_tr);
-        if( debug ) {
-            printf("%s\n", toString().c_str());
-            printf("ac %s\n", ac.toString().c_str());
-            printf("unit_per_pixel norm %s, %f\n", vunit_per_pixel.toString().c_str(), unit_per_pixel);
-            printf("step %s\n", step.toString().c_str());
-            printf("i %s, j %s\n", i.toString().c_str(), j.toString().c_str());
-        }
-        if( 0.0f == step.length_sq() ){
-            lineseg_t::draw(i, j);
-            if( debug ) {
-                printf("z: i %s, j %s\n", i.toString().c_str(), j.toString().c_str());
-            }
-        } else if(m_tl.y < m_bl.y){
-            for(; /*i.x > p_c.x ||*/ i.y <= m_bl.y; i+=step, j+=step) {
-                lineseg_t::draw(i, j);
-                if( debug ) {
-                    printf("a: i %s, j %s\n", i.toString().c_str(), j.toString().c_str());
-                }
-            }
-        }else{
-            for(; /*i.x > p_c.x ||*/ i.y >= m_bl.y; i+=step, j+=step) {
-                lineseg_t::draw(i, j);
-                if( debug ) {
-                    printf("b: i %s, j %s\n", i.toString().c_str(), j.toString().c_str());
-                }
-            }
-        }
-
+        fill_quad_fbcoord(cart_coord.to_fb_x( m_tl.x ), cart_coord.to_fb_y( m_tl.y ),
+                          cart_coord.to_fb_x( m_tr.x ), cart_coord.to_fb_y( m_tr.y ),
+                          cart_coord.to_fb_x( m_br.x ), cart_coord.to_fb_y( m_br.y ),
+                          cart_coord.to_fb_x( m_bl.x ), cart_coord.to_fb_y( m_bl.y ));
     } else {
         lineseg_t::draw(m_tl, m_tr);
         lineseg_t::draw(m_tr, m_br);
@@ -481,17 +1484,9 @@ void pixel::f2::triangle_t::draw(const bool filled) const noexcept {
         lineseg_t::draw(p_b, p_c);
         lineseg_t::draw(p_c, p_a);
     } else {
-        const float x_ival = pixel::cart_coord.width() / (float)pixel::fb_width;
-        const float y_ival = pixel::cart_coord.height() / (float)pixel::fb_height;
-        const aabbox_t b = box();
-        for(float y=b.bl.y; y<=b.tr.y; y+=y_ival) {
-            for(float x=b.bl.x; x<=b.tr.x; x+=x_ival) {
-                const point_t p { x, y };
-                if( contains(p) ){
-                    p.draw();
-                }
-            }
-        }
+        fill_triangle_fbcoord(cart_coord.to_fb_x( p_a.x ), cart_coord.to_fb_y( p_a.y ),
+                              cart_coord.to_fb_x( p_b.x ), cart_coord.to_fb_y( p_b.y ),
+                              cart_coord.to_fb_x( p_c.x ), cart_coord.to_fb_y( p_c.y ));
     }
 }
 
@@ -521,6 +1516,719 @@ pixel::f2::ageom_list_t& pixel::f2::agobjects() {
     return _gobjects;
 }
 
+//
+// pixel::f2::intersects(geom_t, geom_t) narrow-phase
+//
+
+namespace {
+    using pixel::f2::point_t;
+    using pixel::f2::vec_t;
+    using pixel::f2::geom_t;
+    using pixel::f2::shape_t;
+
+    /** Convex polygon of up to 4 vertices, a line segment having 2. */
+    struct convex_t {
+        point_t p[4];
+        int n;
+    };
+
+    /** Shape class indexing the narrow-phase dispatch table */
+    enum class shape_class_t : uint8_t { convex = 0, disk, polyline, other };
+
+    shape_class_t shape_class(const shape_t s) noexcept {
+        switch( s ) {
+            case shape_t::aabbox:
+            case shape_t::lineseg:
+            case shape_t::triangle:
+            case shape_t::rect:
+                return shape_class_t::convex;
+            case shape_t::disk:
+                return shape_class_t::disk;
+            case shape_t::linestrip:
+                return shape_class_t::polyline;
+            default:
+                return shape_class_t::other;
+        }
+    }
+
+    convex_t to_convex(const geom_t& g) noexcept {
+        switch( g.shape() ) {
+            case shape_t::aabbox: {
+                const pixel::f2::aabbox_t& o = static_cast<const pixel::f2::aabbox_t&>(g);
+                return convex_t{ { o.bl, point_t(o.tr.x, o.bl.y), o.tr, point_t(o.bl.x, o.tr.y) }, 4 };
+            }
+            case shape_t::lineseg: {
+                const pixel::f2::lineseg_t& o = static_cast<const pixel::f2::lineseg_t&>(g);
+                return convex_t{ { o.p0, o.p1, point_t(), point_t() }, 2 };
+            }
+            case shape_t::triangle: {
+                const pixel::f2::triangle_t& o = static_cast<const pixel::f2::triangle_t&>(g);
+                return convex_t{ { o.p_a, o.p_b, o.p_c, point_t() }, 3 };
+            }
+            case shape_t::rect: {
+                const pixel::f2::rect_t& o = static_cast<const pixel::f2::rect_t&>(g);
+                return convex_t{ { o.m_tl, o.m_tr, o.m_br, o.m_bl }, 4 };
+            }
+            default:
+                return convex_t{ { point_t(), point_t(), point_t(), point_t() }, 0 };
+        }
+    }
+
+    void project(const convex_t& c, const vec_t& axis, float& lo, float& hi) noexcept {
+        lo = hi = axis.dot(c.p[0]);
+        for(int i = 1; i < c.n; ++i) {
+            const float d = axis.dot(c.p[i]);
+            lo = std::min(lo, d);
+            hi = std::max(hi, d);
+        }
+    }
+
+    bool separated_on(const convex_t& a, const convex_t& b, const vec_t& axis) noexcept {
+        if( jau::is_zero( axis.length_sq() ) ) {
+            return false;
+        }
+        float a_lo, a_hi, b_lo, b_hi;
+        project(a, axis, a_lo, a_hi);
+        project(b, axis, b_lo, b_hi);
+        return a_hi < b_lo || b_hi < a_lo;
+    }
+
+    /** Returns true if one of a's edge normals separates both, a line segment also testing its direction for the collinear case. */
+    bool separated_by(const convex_t& a, const convex_t& b) noexcept {
+        if( 2 == a.n ) {
+            const vec_t d = a.p[1] - a.p[0];
+            return separated_on(a, b, d.normal_ccw()) || separated_on(a, b, d);
+        }
+        for(int i = 0; i < a.n; ++i) {
+            if( separated_on(a, b, ( a.p[(i + 1) % a.n] - a.p[i] ).normal_ccw()) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool convex_convex(const convex_t& a, const convex_t& b) noexcept {
+        if( a.n < 2 || b.n < 2 ) {
+            return false;
+        }
+        return !separated_by(a, b) && !separated_by(b, a);
+    }
+
+    bool convex_disk(const convex_t& a, const point_t& c, const float r) noexcept {
+        if( a.n < 2 ) {
+            return false;
+        }
+        const float r_sq = r * r;
+        // disk touching an edge
+        const int edges = a.n > 2 ? a.n : 1;
+        for(int i = 0; i < edges; ++i) {
+            const pixel::f2::lineseg_t e(a.p[i], a.p[(i + 1) % a.n]);
+            const float d = e.distance(c);
+            if( d * d <= r_sq ) {
+                return true;
+            }
+        }
+        if( a.n < 3 ) {
+            return false;
+        }
+        // disk center inside, i.e. on the same side of all edges
+        int sign = 0;
+        for(int i = 0; i < a.n; ++i) {
+            const float cr = ( a.p[(i + 1) % a.n] - a.p[i] ).cross( c - a.p[i] );
+            const int s = cr < 0 ? -1 : 1;
+            if( 0 == sign ) {
+                sign = s;
+            } else if( s != sign ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Returns a point of the given shape, used for containment tests. */
+    point_t any_point(const geom_t& g) noexcept {
+        switch( shape_class(g.shape()) ) {
+            case shape_class_t::convex:
+                return to_convex(g).p[0];
+            case shape_class_t::disk:
+                return static_cast<const pixel::f2::disk_t&>(g).center;
+            case shape_class_t::polyline: {
+                const pixel::f2::linestrip_t& o = static_cast<const pixel::f2::linestrip_t&>(g);
+                return o.p_list.empty() ? point_t() : o.p_list[0];
+            }
+            default:
+                return g.box().center();
+        }
+    }
+
+    /** Even-odd point in polygon test for a closed linestrip_t */
+    bool polygon_contains(const std::vector<point_t>& pl, const point_t& p) noexcept {
+        bool in = false;
+        for(size_t i = 0, j = pl.size() - 1; i < pl.size(); j = i++) {
+            const point_t& a = pl[i];
+            const point_t& b = pl[j];
+            if( ( a.y > p.y ) != ( b.y > p.y ) &&
+                p.x < ( b.x - a.x ) * ( p.y - a.y ) / ( b.y - a.y ) + a.x ) {
+                in = !in;
+            }
+        }
+        return in;
+    }
+
+    bool test_cc(const geom_t& a, const geom_t& b) noexcept {
+        return convex_convex(to_convex(a), to_convex(b));
+    }
+    bool test_cd(const geom_t& a, const geom_t& b) noexcept {
+        const pixel::f2::disk_t& d = static_cast<const pixel::f2::disk_t&>(b);
+        return convex_disk(to_convex(a), d.center, d.radius);
+    }
+    bool test_dc(const geom_t& a, const geom_t& b) noexcept {
+        return test_cd(b, a);
+    }
+    bool test_dd(const geom_t& a, const geom_t& b) noexcept {
+        const pixel::f2::disk_t& da = static_cast<const pixel::f2::disk_t&>(a);
+        const pixel::f2::disk_t& db = static_cast<const pixel::f2::disk_t&>(b);
+        const float r = da.radius + db.radius;
+        return da.center.dist_sq(db.center) <= r * r;
+    }
+    bool test_pa(const geom_t& a, const geom_t& b) noexcept {
+        const std::vector<point_t>& pl = static_cast<const pixel::f2::linestrip_t&>(a).p_list;
+        if( pl.size() < 2 || !a.box().intersects(b.box()) ) {
+            return false;
+        }
+        for(size_t i = 1; i < pl.size(); ++i) {
+            if( pixel::f2::intersects(pixel::f2::lineseg_t(pl[i - 1], pl[i]), b) ) {
+                return true;
+            }
+        }
+        // b fully inside closed linestrip a
+        return pl.size() > 3 && pl.front() == pl.back() && polygon_contains(pl, any_point(b));
+    }
+    bool test_ap(const geom_t& a, const geom_t& b) noexcept {
+        return test_pa(b, a);
+    }
+    bool test_oa(const geom_t& a, const geom_t& b) noexcept {
+        switch( b.shape() ) {
+            case shape_t::aabbox:
+                return a.intersects(static_cast<const pixel::f2::aabbox_t&>(b));
+            case shape_t::lineseg:
+                return a.intersects(static_cast<const pixel::f2::lineseg_t&>(b));
+            default:
+                return a.intersects(b.box());
+        }
+    }
+    bool test_ao(const geom_t& a, const geom_t& b) noexcept {
+        return test_oa(b, a);
+    }
+    bool test_oo(const geom_t& a, const geom_t& b) noexcept {
+        return a.box().intersects(b.box());
+    }
+
+    typedef bool (*narrow_test_t)(const geom_t& a, const geom_t& b) noexcept;
+
+    /** Narrow-phase dispatch table indexed by shape_class_t of both objects */
+    constexpr narrow_test_t narrow_tests[4][4] = {
+        /* convex   */ { test_cc, test_cd, test_ap, test_ao },
+        /* disk     */ { test_dc, test_dd, test_ap, test_ao },
+        /* polyline */ { test_pa, test_pa, test_pa, test_ao },
+        /* other    */ { test_oa, test_oa, test_oa, test_oo },
+    };
+}
+
+bool pixel::f2::intersects(const geom_t& a, const geom_t& b) noexcept {
+    return narrow_tests[static_cast<int>(shape_class(a.shape()))][static_cast<int>(shape_class(b.shape()))](a, b);
+}
+
+//
+// pixel::f2::grid_index_t
+//
+
+/**
+ * Conservative broadphase test of a line segment against a box,
+ * padding the box by a relative epsilon so segments touching an edge or endpoint are never dropped.
+ */
+static bool lineseg_box_overlap(const pixel::f2::lineseg_t& l, const pixel::f2::aabbox_t& box) noexcept {
+    const float m = std::max( { 1.0f, std::abs(box.bl.x), std::abs(box.bl.y), std::abs(box.tr.x), std::abs(box.tr.y) } );
+    const float eps = 8.0f * std::numeric_limits<float>::epsilon() * m;
+    return l.intersects( pixel::f2::aabbox_t(box.bl - pixel::f2::vec_t(eps, eps), box.tr + pixel::f2::vec_t(eps, eps)) );
+}
+
+pixel::f2::grid_index_t::grid_index_t(const float cell_size) noexcept
+: m_cell_size( std::max(cell_size, std::numeric_limits<float>::epsilon()) ),
+  m_inv_cell_size( 1.0f / m_cell_size ), m_stamp(0)
+{ }
+
+int pixel::f2::grid_index_t::to_cell(const float v) const noexcept {
+    // clamp before the cast, as unset aabbox_t use +/- float max
+    constexpr float lim = float(1 << 30);
+    return static_cast<int>( std::floor( std::clamp(v * m_inv_cell_size, -lim, lim) ) );
+}
+
+pixel::f2::grid_index_t::cell_range_t pixel::f2::grid_index_t::to_cells(const aabbox_t& box) const noexcept {
+    return cell_range_t{ to_cell(box.bl.x), to_cell(box.bl.y), to_cell(box.tr.x), to_cell(box.tr.y) };
+}
+
+void pixel::f2::grid_index_t::link(const uint32_t idx) noexcept {
+    entry_t& e = m_entries[idx];
+    e.cells = to_cells(e.box);
+    e.oversized = e.cells.x1 < e.cells.x0 || e.cells.y1 < e.cells.y0 || e.cells.count() > max_object_cells;
+    if( e.oversized ) {
+        m_oversized.push_back(idx);
+        return;
+    }
+    for(int y = e.cells.y0; y <= e.cells.y1; ++y) {
+        for(int x = e.cells.x0; x <= e.cells.x1; ++x) {
+            m_cells[cell_key(x, y)].push_back(idx);
+        }
+    }
+}
+
+void pixel::f2::grid_index_t::unlink(const uint32_t idx) noexcept {
+    auto erase_idx = [idx](std::vector<uint32_t>& v) {
+        auto it = std::find(v.begin(), v.end(), idx);
+        if( it != v.end() ) {
+            *it = v.back();
+            v.pop_back();
+        }
+    };
+    const entry_t& e = m_entries[idx];
+    if( e.oversized ) {
+        erase_idx(m_oversized);
+        return;
+    }
+    for(int y = e.cells.y0; y <= e.cells.y1; ++y) {
+        for(int x = e.cells.x0; x <= e.cells.x1; ++x) {
+            auto it = m_cells.find(cell_key(x, y));
+            if( it != m_cells.end() ) {
+                erase_idx(it->second);
+                if( it->second.empty() ) {
+                    m_cells.erase(it);
+                }
+            }
+        }
+    }
+}
+
+bool pixel::f2::grid_index_t::insert(const geom_ref_t& g) noexcept {
+    if( !g || m_index.contains(g.get()) ) {
+        return false;
+    }
+    uint32_t idx;
+    if( m_free.empty() ) {
+        idx = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back( entry_t{ g, g->box(), cell_range_t{0, 0, -1, -1}, false } );
+        m_stamps.push_back(0);
+    } else {
+        idx = m_free.back();
+        m_free.pop_back();
+        m_entries[idx] = entry_t{ g, g->box(), cell_range_t{0, 0, -1, -1}, false };
+    }
+    m_index[g.get()] = idx;
+    link(idx);
+    return true;
+}
+
+bool pixel::f2::grid_index_t::update(const geom_ref_t& g) noexcept {
+    if( !g ) {
+        return false;
+    }
+    auto it = m_index.find(g.get());
+    if( it == m_index.end() ) {
+        return false;
+    }
+    const uint32_t idx = it->second;
+    entry_t& e = m_entries[idx];
+    e.box = g->box();
+    if( !e.oversized && to_cells(e.box) == e.cells ) {
+        return true;
+    }
+    unlink(idx);
+    link(idx);
+    return true;
+}
+
+void pixel::f2::grid_index_t::update_all() noexcept {
+    for(const auto& [g, idx] : m_index) {
+        entry_t& e = m_entries[idx];
+        e.box = e.obj->box();
+        if( e.oversized || to_cells(e.box) != e.cells ) {
+            unlink(idx);
+            link(idx);
+        }
+    }
+}
+
+bool pixel::f2::grid_index_t::remove(const geom_ref_t& g) noexcept {
+    if( !g ) {
+        return false;
+    }
+    auto it = m_index.find(g.get());
+    if( it == m_index.end() ) {
+        return false;
+    }
+    const uint32_t idx = it->second;
+    unlink(idx);
+    m_entries[idx].obj = nullptr;
+    m_free.push_back(idx);
+    m_index.erase(it);
+    return true;
+}
+
+void pixel::f2::grid_index_t::clear() noexcept {
+    m_entries.clear();
+    m_free.clear();
+    m_oversized.clear();
+    m_index.clear();
+    m_cells.clear();
+    m_stamps.clear();
+    m_stamp = 0;
+}
+
+uint32_t pixel::f2::grid_index_t::next_stamp() const noexcept {
+    if( ++m_stamp == 0 ) {
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_stamp = 1;
+    }
+    return m_stamp;
+}
+
+size_t pixel::f2::grid_index_t::visit(geom_list_t& res, const std::vector<uint32_t>& idxs, const uint32_t stamp,
+                                      const aabbox_t* box, const lineseg_t* l) const noexcept {
+    size_t n = 0;
+    for(const uint32_t idx : idxs) {
+        if( m_stamps[idx] == stamp ) {
+            continue;
+        }
+        m_stamps[idx] = stamp;
+        const entry_t& e = m_entries[idx];
+        if( ( box && box->intersects(e.box) ) || ( l && lineseg_box_overlap(*l, e.box) ) ) {
+            res.push_back(e.obj);
+            ++n;
+        }
+    }
+    return n;
+}
+
+size_t pixel::f2::grid_index_t::query(geom_list_t& res, const aabbox_t& box) const noexcept {
+    if( m_index.empty() ) {
+        return 0;
+    }
+    const uint32_t stamp = next_stamp();
+    size_t n = visit(res, m_oversized, stamp, &box, nullptr);
+    const cell_range_t r = to_cells(box);
+    if( r.x1 < r.x0 || r.y1 < r.y0 ) {
+        return n;
+    }
+    if( r.count() > static_cast<int64_t>(m_cells.size()) ) {
+        // query covers more cells than are occupied
+        for(const auto& [key, idxs] : m_cells) {
+            const int x = static_cast<int>( static_cast<uint32_t>(key >> 32) );
+            const int y = static_cast<int>( static_cast<uint32_t>(key) );
+            if( r.x0 <= x && x <= r.x1 && r.y0 <= y && y <= r.y1 ) {
+                n += visit(res, idxs, stamp, &box, nullptr);
+            }
+        }
+        return n;
+    }
+    for(int y = r.y0; y <= r.y1; ++y) {
+        for(int x = r.x0; x <= r.x1; ++x) {
+            auto it = m_cells.find(cell_key(x, y));
+            if( it != m_cells.end() ) {
+                n += visit(res, it->second, stamp, &box, nullptr);
+            }
+        }
+    }
+    return n;
+}
+
+size_t pixel::f2::grid_index_t::query(geom_list_t& res, const lineseg_t& l) const noexcept {
+    if( m_index.empty() ) {
+        return 0;
+    }
+    const uint32_t stamp = next_stamp();
+    size_t n = visit(res, m_oversized, stamp, nullptr, &l);
+    const cell_range_t r = to_cells(l.box());
+    if( r.count() > static_cast<int64_t>(m_cells.size()) ) {
+        for(const auto& [key, idxs] : m_cells) {
+            const int x = static_cast<int>( static_cast<uint32_t>(key >> 32) );
+            const int y = static_cast<int>( static_cast<uint32_t>(key) );
+            if( r.x0 <= x && x <= r.x1 && r.y0 <= y && y <= r.y1 ) {
+                n += visit(res, idxs, stamp, nullptr, &l);
+            }
+        }
+        return n;
+    }
+    // walk the cell rows covered by the segment, clipping it to each row for its column span
+    const float dy = l.p1.y - l.p0.y;
+    for(int y = r.y0; y <= r.y1; ++y) {
+        int x0 = r.x0, x1 = r.x1;
+        if( !jau::is_zero(dy) ) {
+            const float row_lo = static_cast<float>(y) * m_cell_size;
+            const float row_hi = row_lo + m_cell_size;
+            const float t0 = std::clamp( ( row_lo - l.p0.y ) / dy, 0.0f, 1.0f );
+            const float t1 = std::clamp( ( row_hi - l.p0.y ) / dy, 0.0f, 1.0f );
+            const float xa = l.p0.x + ( l.p1.x - l.p0.x ) * t0;
+            const float xb = l.p0.x + ( l.p1.x - l.p0.x ) * t1;
+            // widen by one cell against rounding at the row borders
+            x0 = std::max(r.x0, to_cell(std::min(xa, xb)) - 1);
+            x1 = std::min(r.x1, to_cell(std::max(xa, xb)) + 1);
+        }
+        for(int x = x0; x <= x1; ++x) {
+            auto it = m_cells.find(cell_key(x, y));
+            if( it != m_cells.end() ) {
+                n += visit(res, it->second, stamp, nullptr, &l);
+            }
+        }
+    }
+    return n;
+}
+
+std::string pixel::f2::grid_index_t::toString() const noexcept {
+    size_t refs = 0;
+    for(const auto& [key, idxs] : m_cells) {
+        refs += idxs.size();
+    }
+    return "grid_index[cell "+std::to_string(m_cell_size)+", objects "+std::to_string(size())+
+           ", oversized "+std::to_string(m_oversized.size())+", cells "+std::to_string(m_cells.size())+
+           ", refs "+std::to_string(refs)+"]";
+}
+
+//
+// pixel::f2::bvh_t
+//
+
+uint32_t pixel::f2::bvh_t::build_node(std::vector<uint32_t>& idxs, const std::vector<point_t>& centers, const uint32_t first, const uint32_t count) noexcept {
+    const uint32_t node_idx = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back( node_t{ aabbox_t(), first, count } );
+    aabbox_t box, cbox;
+    for(uint32_t i = first; i < first + count; ++i) {
+        box.resize(m_boxes[idxs[i]]);
+        cbox.resize(centers[idxs[i]]);
+    }
+    m_nodes[node_idx].box = box;
+    if( count <= max_leaf_size ) {
+        return node_idx;
+    }
+    // median split along the longest centroid axis
+    const bool x_axis = cbox.width() >= cbox.height();
+    const uint32_t mid = first + count / 2;
+    std::nth_element(idxs.begin() + first, idxs.begin() + mid, idxs.begin() + first + count,
+        [&](const uint32_t a, const uint32_t b) {
+            return x_axis ? centers[a].x < centers[b].x : centers[a].y < centers[b].y;
+        });
+    build_node(idxs, centers, first, mid - first);
+    const uint32_t right = build_node(idxs, centers, mid, first + count - mid);
+    m_nodes[node_idx].first = right;
+    m_nodes[node_idx].count = 0;
+    return node_idx;
+}
+
+void pixel::f2::bvh_t::build(const geom_list_t& list) noexcept {
+    clear();
+    geom_list_t objs;
+    std::vector<uint32_t> idxs;
+    std::vector<point_t> centers;
+    objs.reserve(list.size());
+    idxs.reserve(list.size());
+    centers.reserve(list.size());
+    m_boxes.reserve(list.size());
+    for(const geom_ref_t& g : list) {
+        if( g ) {
+            idxs.push_back( static_cast<uint32_t>(objs.size()) );
+            objs.push_back( g );
+            m_boxes.push_back( g->box() );
+            centers.push_back( m_boxes.back().center() );
+        }
+    }
+    if( idxs.empty() ) {
+        m_boxes.clear();
+        return;
+    }
+    m_nodes.reserve( 2 * idxs.size() / max_leaf_size + 1 );
+    build_node(idxs, centers, 0, static_cast<uint32_t>(idxs.size()));
+
+    // store objects and boxes in leaf order
+    std::vector<aabbox_t> boxes;
+    boxes.reserve(idxs.size());
+    m_objs.reserve(idxs.size());
+    for(const uint32_t idx : idxs) {
+        m_objs.push_back( objs[idx] );
+        boxes.push_back( m_boxes[idx] );
+    }
+    m_boxes = std::move(boxes);
+}
+
+void pixel::f2::bvh_t::clear() noexcept {
+    m_nodes.clear();
+    m_objs.clear();
+    m_boxes.clear();
+}
+
+size_t pixel::f2::bvh_t::query(geom_list_t& res, const aabbox_t& box) const noexcept {
+    if( m_nodes.empty() ) {
+        return 0;
+    }
+    size_t n = 0;
+    uint32_t stack[64];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const uint32_t node_idx = stack[--sp];
+        const node_t& node = m_nodes[node_idx];
+        if( !box.intersects(node.box) ) {
+            continue;
+        }
+        if( node.count > 0 ) {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if( box.intersects(m_boxes[i]) ) {
+                    res.push_back(m_objs[i]);
+                    ++n;
+                }
+            }
+        } else {
+            stack[sp++] = node.first;
+            stack[sp++] = node_idx + 1;
+        }
+    }
+    return n;
+}
+
+size_t pixel::f2::bvh_t::query(geom_list_t& res, const lineseg_t& l) const noexcept {
+    if( m_nodes.empty() ) {
+        return 0;
+    }
+    size_t n = 0;
+    uint32_t stack[64];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const uint32_t node_idx = stack[--sp];
+        const node_t& node = m_nodes[node_idx];
+        if( !lineseg_box_overlap(l, node.box) ) {
+            continue;
+        }
+        if( node.count > 0 ) {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if( lineseg_box_overlap(l, m_boxes[i]) ) {
+                    res.push_back(m_objs[i]);
+                    ++n;
+                }
+            }
+        } else {
+            stack[sp++] = node.first;
+            stack[sp++] = node_idx + 1;
+        }
+    }
+    return n;
+}
+
+static float box_dist_sq(const pixel::f2::aabbox_t& box, const pixel::f2::point_t& p) noexcept {
+    const float dx = std::max( { box.bl.x - p.x, 0.0f, p.x - box.tr.x } );
+    const float dy = std::max( { box.bl.y - p.y, 0.0f, p.y - box.tr.y } );
+    return dx * dx + dy * dy;
+}
+
+pixel::f2::geom_ref_t pixel::f2::bvh_t::nearest(float& dist, const point_t& p) const noexcept {
+    if( m_nodes.empty() ) {
+        return nullptr;
+    }
+    float best = std::numeric_limits<float>::max();
+    uint32_t best_idx = 0;
+    uint32_t stack[64];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const uint32_t node_idx = stack[--sp];
+        const node_t& node = m_nodes[node_idx];
+        if( box_dist_sq(node.box, p) >= best ) {
+            continue;
+        }
+        if( node.count > 0 ) {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const float d = box_dist_sq(m_boxes[i], p);
+                if( d < best ) {
+                    best = d;
+                    best_idx = i;
+                }
+            }
+        } else {
+            // visit the nearer child first, i.e. push it last
+            const uint32_t l = node_idx + 1, r = node.first;
+            if( box_dist_sq(m_nodes[l].box, p) < box_dist_sq(m_nodes[r].box, p) ) {
+                stack[sp++] = r;
+                stack[sp++] = l;
+            } else {
+                stack[sp++] = l;
+                stack[sp++] = r;
+            }
+        }
+    }
+    dist = std::sqrt(best);
+    return m_objs[best_idx];
+}
+
+pixel::f2::geom_ref_t pixel::f2::bvh_t::raycast(float& dist, point_t& cross_point, vec_t& cross_normal,
+                                                const ray_t& ray, const float max_dist) const noexcept {
+    if( m_nodes.empty() ) {
+        return nullptr;
+    }
+    float best = max_dist;
+    geom_ref_t hit;
+    uint32_t stack[64];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const uint32_t node_idx = stack[--sp];
+        const node_t& node = m_nodes[node_idx];
+        float t_near, t_far;
+        if( !ray.intersects(t_near, t_far, node.box) || t_near >= best ) {
+            continue;
+        }
+        if( node.count > 0 ) {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if( !ray.intersects(t_near, t_far, m_boxes[i]) || t_near >= best ) {
+                    continue;
+                }
+                // exact test with the ray segment spanning the object's box
+                const lineseg_t in(ray.orig, ray.at( std::min(best, t_far * 1.001f + 0.001f) ));
+                vec_t reflect, normal;
+                point_t cp;
+                if( m_objs[i]->intersection(reflect, normal, cp, in) ) {
+                    const float d = ray.orig.dist(cp);
+                    if( d < best ) {
+                        best = d;
+                        hit = m_objs[i];
+                        cross_point = cp;
+                        cross_normal = normal;
+                    }
+                }
+            }
+        } else {
+            // visit the nearer child first, i.e. push it last
+            const uint32_t l = node_idx + 1, r = node.first;
+            float tl = std::numeric_limits<float>::max(), tr = std::numeric_limits<float>::max();
+            const bool hl = ray.intersects(tl, m_nodes[l].box);
+            const bool hr = ray.intersects(tr, m_nodes[r].box);
+            if( hl && hr ) {
+                stack[sp++] = tl < tr ? r : l;
+                stack[sp++] = tl < tr ? l : r;
+            } else if( hl ) {
+                stack[sp++] = l;
+            } else if( hr ) {
+                stack[sp++] = r;
+            }
+        }
+    }
+    if( hit ) {
+        dist = best;
+    }
+    return hit;
+}
+
+std::string pixel::f2::bvh_t::toString() const noexcept {
+    return "bvh[objects "+std::to_string(size())+", nodes "+std::to_string(m_nodes.size())+", box "+box().toString()+"]";
+}
+
 bool pixel::f2::aabbox_t::intersects(const lineseg_t & o) const noexcept {
     return o.intersects(*this);
 }
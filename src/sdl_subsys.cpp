@@ -23,14 +23,20 @@
  */
 #include "pixel/pixel.hpp"
 #include "pixel/version.hpp"
+#include "pixel/asset_archive.hpp"
 #include <jau/file_util.hpp>
 #include <jau/fraction_type.hpp>
 #include <jau/utils.hpp>
 
 #include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_scancode.h>
@@ -43,12 +49,13 @@ using namespace jau;
 
 static SDL_Window* sdl_win = nullptr;
 static SDL_Renderer* sdl_rend = nullptr;
+/** Offscreen render target if headless */
+static SDL_Surface* sdl_headless_surface = nullptr;
 static float fb_origin_norm[2] = { 0.0f, 0.0f };
 static size_t fb_pixels_dim_size = 0;
 static size_t fb_pixels_byte_size = 0;
 static size_t fb_pixels_byte_width = 0;
 static SDL_Texture * fb_texture = nullptr;
-static TTF_Font* sdl_font = nullptr;
 static int monitor_frames_per_sec=60;
 static int gpu_forced_fps_ = -1;
 static bool gpu_fps_resync = true;
@@ -58,6 +65,165 @@ static int64_t gpu_frame_count = 0;
 static fraction_timespec gpu_fps_t0;
 static fraction_timespec gpu_swap_t0;
 static fraction_timespec gpu_swap_t1;
+static bool skip_unchanged_frames_val = false;
+/** True if any render operation besides clearing has been issued since the last present */
+static bool rend_changed = true;
+/** Union of software writes (fb_dirty) since the last clear_pixel_fb(), already uploaded */
+static fb_region_t fb_drawn;
+/** Region to upload at swap_pixel_fb() besides fb_dirty, i.e. refilled by clear_pixel_fb() or invalidated */
+static fb_region_t fb_upload;
+/** Region uploaded by the last swap_pixel_fb() */
+static fb_region_t fb_uploaded;
+/** True if fb_pixels outside of fb_drawn and fb_dirty holds fb_clear_color */
+static bool fb_clear_valid = false;
+static uint32_t fb_clear_color = 0;
+static bool fb_streaming_val = false;
+/** True if fb_texture is locked into fb_data */
+static bool fb_locked = false;
+
+static constexpr const bool DEBUG_BATCH = false;
+static constexpr const bool DEBUG_TEX = false;
+
+/**
+ * Per-frame command buffer of subsys primitives sharing one draw color.
+ *
+ * Primitives of the same color are order independent, hence they are grouped by type
+ * and submitted with one SDL call per type at flush. A color change flushes the buffer,
+ * preserving the draw order between colors.
+ */
+struct cmd_buffer_t {
+    /** Draw color of the recorded primitives */
+    SDL_Color color = { 0, 0, 0, 0 };
+    /** Draw color last set on the renderer */
+    SDL_Color rend_color = { 0, 0, 0, 0 };
+    bool rend_color_valid = false;
+    std::vector<SDL_Point> points;
+    /** Poly-line chains of connected lines, each starting at the index stored in line_chains */
+    std::vector<SDL_Point> lines;
+    std::vector<size_t> line_chains;
+    std::vector<SDL_Rect> fill_rects;
+    std::vector<SDL_Rect> draw_rects;
+    /** Texture of the pending sprite quads, sprites and primitives are never pending at once */
+    SDL_Texture* sprite_tex = nullptr;
+    /** Blend mode of the pending sprite quads, blend_mode_t::native keeps the texture's blend mode */
+    pixel::blend_mode_t sprite_blend = pixel::blend_mode_t::native;
+    int sprite_tex_width = 0;
+    int sprite_tex_height = 0;
+    std::vector<SDL_Vertex> sprite_vertices;
+    std::vector<int> sprite_indices;
+    pixel::subsys_batch_stats_t frame_stats;
+    pixel::subsys_batch_stats_t last_stats;
+
+    bool empty() const noexcept {
+        return points.empty() && lines.empty() && fill_rects.empty() && draw_rects.empty();
+    }
+    void clear() noexcept {
+        points.clear();
+        lines.clear();
+        line_chains.clear();
+        fill_rects.clear();
+        draw_rects.clear();
+        sprite_vertices.clear();
+        sprite_indices.clear();
+    }
+};
+static cmd_buffer_t cmd_buf;
+
+static SDL_BlendMode to_sdl_blend(const pixel::blend_mode_t m) noexcept {
+    switch( m ) {
+        case pixel::blend_mode_t::none:  return SDL_BLENDMODE_NONE;
+        case pixel::blend_mode_t::add:   return SDL_BLENDMODE_ADD;
+        case pixel::blend_mode_t::mod:   return SDL_BLENDMODE_MOD;
+        case pixel::blend_mode_t::mul:   return SDL_BLENDMODE_MUL;
+        default:                         return SDL_BLENDMODE_BLEND;
+    }
+}
+
+/** Submits the pending sprite quads with one SDL_RenderGeometry call */
+static void sprite_flush() noexcept {
+    if( cmd_buf.sprite_vertices.empty() ) {
+        return;
+    }
+    // the blend mode is state of the shared SDL_Texture, hence restored after the submission
+    const bool blend_set = pixel::blend_mode_t::native != cmd_buf.sprite_blend && nullptr != cmd_buf.sprite_tex;
+    SDL_BlendMode blend_orig = SDL_BLENDMODE_NONE;
+    if( blend_set ) {
+        SDL_GetTextureBlendMode(cmd_buf.sprite_tex, &blend_orig);
+        SDL_SetTextureBlendMode(cmd_buf.sprite_tex, to_sdl_blend(cmd_buf.sprite_blend));
+    }
+    const int err = SDL_RenderGeometry(sdl_rend, cmd_buf.sprite_tex, cmd_buf.sprite_vertices.data(), int(cmd_buf.sprite_vertices.size()),
+                                       cmd_buf.sprite_indices.data(), int(cmd_buf.sprite_indices.size()));
+    if( blend_set ) {
+        SDL_SetTextureBlendMode(cmd_buf.sprite_tex, blend_orig);
+    }
+    ++cmd_buf.frame_stats.submitted;
+    rend_changed = true;
+    if( 0 != err ) {
+        log_printf("SDL_RenderGeometry: %zu sprite vertices, err %d, %s\n", cmd_buf.sprite_vertices.size(), err, SDL_GetError());
+    }
+    cmd_buf.sprite_vertices.clear();
+    cmd_buf.sprite_indices.clear();
+}
+
+/** Counts a recorded primitive, submitting pending sprites first to preserve the draw order */
+static void cmd_record() noexcept {
+    ++cmd_buf.frame_stats.recorded;
+    if( !cmd_buf.sprite_vertices.empty() ) {
+        sprite_flush();
+    }
+}
+
+/**
+ * Enqueues a textured quad of src within tex into the sprite batch at dest rotated by angle_deg clockwise around its center.
+ *
+ * The vertex color modulates the texture color and alpha like SDL_SetTextureColorMod() and SDL_SetTextureAlphaMod(),
+ * but per quad, leaving the shared SDL_Texture untouched.
+ * A texture or blend mode change flushes the pending sprites.
+ */
+static void sprite_enqueue(SDL_Texture* tex, const SDL_Rect& src, const SDL_FRect& dest, const float angle_deg, const SDL_Color color,
+                           const pixel::blend_mode_t blend=pixel::blend_mode_t::native) noexcept {
+    ++cmd_buf.frame_stats.recorded;
+    if( tex != cmd_buf.sprite_tex || blend != cmd_buf.sprite_blend || cmd_buf.sprite_vertices.empty() ) {
+        // flushes pending sprites or primitives
+        pixel::subsys_flush();
+        cmd_buf.sprite_tex = tex;
+        cmd_buf.sprite_blend = blend;
+        SDL_QueryTexture(tex, nullptr, nullptr, &cmd_buf.sprite_tex_width, &cmd_buf.sprite_tex_height);
+    }
+    const float su = 1.0f / (float)std::max(1, cmd_buf.sprite_tex_width);
+    const float sv = 1.0f / (float)std::max(1, cmd_buf.sprite_tex_height);
+    const float u0 = (float)src.x * su, u1 = (float)( src.x + src.w ) * su;
+    const float v0 = (float)src.y * sv, v1 = (float)( src.y + src.h ) * sv;
+    const float hw = dest.w * 0.5f, hh = dest.h * 0.5f;
+    const float cx = dest.x + hw, cy = dest.y + hh;
+    float ax = -hw, ay = -hh, bx = hw, by = -hh; // top-left, top-right corner relative to center
+    if( 0.0f != angle_deg ) {
+        const float rad = angle_deg * (float)M_PI / 180.0f;
+        const float cs = std::cos(rad), sn = std::sin(rad);
+        ax = -hw * cs + hh * sn; ay = -hw * sn - hh * cs;
+        bx =  hw * cs + hh * sn; by =  hw * sn - hh * cs;
+    }
+    // bottom-right = -top-left, bottom-left = -top-right
+    const int i0 = int(cmd_buf.sprite_vertices.size());
+    cmd_buf.sprite_vertices.push_back( SDL_Vertex { { cx + ax, cy + ay }, color, { u0, v0 } } );
+    cmd_buf.sprite_vertices.push_back( SDL_Vertex { { cx + bx, cy + by }, color, { u1, v0 } } );
+    cmd_buf.sprite_vertices.push_back( SDL_Vertex { { cx - ax, cy - ay }, color, { u1, v1 } } );
+    cmd_buf.sprite_vertices.push_back( SDL_Vertex { { cx - bx, cy - by }, color, { u0, v1 } } );
+    cmd_buf.sprite_indices.insert(cmd_buf.sprite_indices.end(), { i0, i0 + 1, i0 + 2, i0, i0 + 2, i0 + 3 });
+}
+
+static bool operator==(const SDL_Color& a, const SDL_Color& b) noexcept {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static void cmd_apply_color() noexcept {
+    if( !cmd_buf.rend_color_valid || !( cmd_buf.rend_color == cmd_buf.color ) ) {
+        SDL_SetRenderDrawColor(sdl_rend, cmd_buf.color.r, cmd_buf.color.g, cmd_buf.color.b, cmd_buf.color.a);
+        cmd_buf.rend_color = cmd_buf.color;
+        cmd_buf.rend_color_valid = true;
+        ++cmd_buf.frame_stats.submitted;
+    }
+}
 
 uint32_t pixel::rgba_to_uint32(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept {
     // SDL_PIXELFORMAT_ARGB8888
@@ -90,14 +256,258 @@ int pixel::gpu_forced_fps() noexcept { return gpu_forced_fps_; }
 
 void pixel::set_gpu_forced_fps(int fps) noexcept { gpu_forced_fps_=fps; reset_gpu_fps(fps); }
 
+void pixel::set_skip_unchanged_frames(bool v) noexcept { skip_unchanged_frames_val=v; rend_changed=true; }
+
+bool pixel::skip_unchanged_frames() noexcept { return skip_unchanged_frames_val; }
+
+static void unlock_fb_texture() noexcept {
+    if( fb_locked ) {
+        SDL_UnlockTexture(fb_texture);
+        fb_locked = false;
+    }
+    fb_data = fb_pixels.data();
+    fb_stride = fb_width;
+}
+
+static void create_fb_texture() noexcept {
+    unlock_fb_texture();
+    if( nullptr != fb_texture ) {
+        SDL_DestroyTexture( fb_texture );
+        fb_texture = nullptr;
+    }
+    if( !use_subsys_primitives_val ) {
+        const int access = fb_streaming_val ? SDL_TEXTUREACCESS_STREAMING : SDL_TEXTUREACCESS_STATIC;
+        fb_texture = SDL_CreateTexture(sdl_rend, SDL_PIXELFORMAT_ARGB8888, access, fb_width, fb_height);
+    }
+    fb_drawn.clear();
+    fb_upload.set_all();
+    fb_clear_valid = false;
+    rend_changed = true;
+}
+
+void pixel::set_fb_streaming(bool v) noexcept {
+    if( v != fb_streaming_val ) {
+        fb_streaming_val = v;
+        if( sdl_rend ) {
+            create_fb_texture();
+        }
+    }
+}
+
+bool pixel::fb_streaming() noexcept { return fb_streaming_val; }
+
+void pixel::fb_begin_frame() noexcept {
+    fb_tiles_flush();
+    if( !fb_streaming_val || fb_locked || nullptr == fb_texture ) {
+        return;
+    }
+    void* pixels = nullptr;
+    int pitch = 0;
+    if( 0 != SDL_LockTexture(fb_texture, nullptr, &pixels, &pitch) ) {
+        log_printf("SDL_LockTexture: %s\n", SDL_GetError());
+        return;
+    }
+    fb_data = static_cast<uint32_t*>(pixels);
+    fb_stride = pitch / 4;
+    fb_locked = true;
+}
+
+//
+// Fonts
+//
+
+namespace {
+    /** Latin-1 glyph of a glyph atlas, rendered like a single character string */
+    struct atlas_glyph_t {
+        SDL_Rect src;
+        /** glyph offset to the pen position */
+        int dx;
+        int advance;
+    };
+    constexpr Uint16 glyph_first = 32;
+    constexpr Uint16 glyph_count = 256 - glyph_first;
+
+    /** Font of one pixel size with its lazily built glyph atlas */
+    struct font_entry_t {
+        TTF_Font* font;
+        texture_ref atlas;
+        std::vector<atlas_glyph_t> glyphs;
+        uint64_t last_use;
+    };
+    constexpr size_t font_cache_max = 16;
+    /** Font file data, read once and shared by all font sizes unless mapped from the asset archive */
+    std::vector<uint8_t> font_data;
+    /** Font data used by all font sizes, either font_data or the mapped asset archive */
+    pixel::asset_data_t font_mem;
+    bool font_data_read = false;
+    bool font_open_warn_once = true;
+    std::unordered_map<int, font_entry_t> font_cache;
+    uint64_t font_use_count = 0;
+
+    bool read_font_data() noexcept {
+        if( font_data_read ) {
+            return font_mem.valid();
+        }
+        font_data_read = true;
+        const std::string fontfile = "fonts/freefont/FreeSansBold.ttf";
+        font_mem = pixel::find_archived_asset(fontfile);
+        if( font_mem.valid() ) {
+            // zero-copy, the archive stays mapped
+            printf("Using font %s from %s, %zu bytes\n", fontfile.c_str(), pixel::asset_archive().c_str(), font_mem.size);
+            return true;
+        }
+        const std::string fontpath = pixel::resolve_asset(fontfile);
+        if( !fontpath.size() ) {
+            log_printf("font: No asset path for font-file '%s' in asset dir '%s'\n", fontfile.c_str(), pixel::asset_dir().c_str());
+            return false;
+        }
+        SDL_RWops* rw = SDL_RWFromFile(fontpath.c_str(), "rb");
+        const Sint64 size = nullptr != rw ? SDL_RWsize(rw) : -1;
+        if( 0 < size ) {
+            font_data.resize(size_t(size));
+            if( 1 != SDL_RWread(rw, font_data.data(), font_data.size(), 1) ) {
+                font_data.clear();
+            }
+        }
+        if( nullptr != rw ) {
+            SDL_RWclose(rw);
+        }
+        if( font_data.empty() ) {
+            fprintf(stderr, "font: Error reading '%s': %s\n", fontpath.c_str(), SDL_GetError());
+            return false;
+        }
+        printf("Using font %s, %zu bytes\n", fontpath.c_str(), font_data.size());
+        font_mem = pixel::asset_data_t { .data=font_data.data(), .size=font_data.size() };
+        return true;
+    }
+
+    /**
+     * Returns the cached font of given pixel size, opened lazily from font_data.
+     *
+     * Least recently used sizes are closed beyond font_cache_max, except font_height.
+     * Text textures keep their glyph atlas alive.
+     */
+    font_entry_t* get_font(const int size) noexcept {
+        if( 0 >= size ) {
+            return nullptr;
+        }
+        ++font_use_count;
+        auto it = font_cache.find(size);
+        if( it != font_cache.end() ) {
+            it->second.last_use = font_use_count;
+            return &it->second;
+        }
+        if( !read_font_data() ) {
+            return nullptr;
+        }
+        SDL_RWops* rw = SDL_RWFromConstMem(font_mem.data, int(font_mem.size));
+        TTF_Font* font = nullptr != rw ? TTF_OpenFontRW(rw, 1 /* freesrc */, size) : nullptr;
+        if( nullptr == font ) {
+            if( font_open_warn_once ) {
+                fprintf(stderr, "font: Null font of size %d: %s\n", size, SDL_GetError());
+                font_open_warn_once = false;
+            }
+            return nullptr;
+        }
+        if( font_cache.size() >= font_cache_max ) {
+            auto lru = font_cache.end();
+            for(auto i = font_cache.begin(); i != font_cache.end(); ++i) {
+                if( i->first != font_height && ( lru == font_cache.end() || i->second.last_use < lru->second.last_use ) ) {
+                    lru = i;
+                }
+            }
+            if( lru != font_cache.end() ) {
+                if( lru->second.atlas && lru->second.atlas->handle() == cmd_buf.sprite_tex ) {
+                    // pending glyph quads still reference the atlas
+                    sprite_flush();
+                }
+                TTF_CloseFont(lru->second.font);
+                font_cache.erase(lru);
+            }
+        }
+        font_entry_t& f = font_cache[size];
+        f = font_entry_t { font, nullptr, {}, font_use_count };
+        return &f;
+    }
+
+    /** Builds the white glyph atlas of given font */
+    bool build_glyph_atlas(font_entry_t& f) noexcept {
+        const SDL_Color white = { 255, 255, 255, 255 };
+        const int height = TTF_FontHeight(f.font);
+        std::vector<SDL_Surface*> surfaces(glyph_count, nullptr);
+        f.glyphs.assign(glyph_count, atlas_glyph_t { { 0, 0, 0, 0 }, 0, 0 });
+
+        int64_t area = 0;
+        int max_w = 1;
+        for(Uint16 i=0; i<glyph_count; ++i) {
+            const Uint16 ch = Uint16(glyph_first + i);
+            atlas_glyph_t& g = f.glyphs[i];
+            int minx, maxx, miny, maxy;
+            if( 0 != TTF_GlyphMetrics(f.font, ch, &minx, &maxx, &miny, &maxy, &g.advance) ) {
+                continue;
+            }
+            g.dx = std::min(0, minx);
+            surfaces[i] = TTF_RenderGlyph_Solid(f.font, ch, white);
+            if( nullptr != surfaces[i] ) {
+                area += int64_t(surfaces[i]->w + 1) * ( height + 1 );
+                max_w = std::max(max_w, surfaces[i]->w);
+            }
+        }
+        // shelf layout of all glyphs with 1 pixel padding, each as tall as the font, in a roughly square atlas
+        const int atlas_width = std::max(max_w, (int)std::ceil( std::sqrt( (double)area ) ));
+        int pen_x = 0, pen_y = 0;
+        for(Uint16 i=0; i<glyph_count; ++i) {
+            if( nullptr != surfaces[i] ) {
+                const int w = surfaces[i]->w;
+                if( pen_x + w > atlas_width ) {
+                    pen_x = 0;
+                    pen_y += height + 1;
+                }
+                f.glyphs[i].src = { pen_x, pen_y, w, std::min(surfaces[i]->h, height) };
+                pen_x += w + 1;
+            }
+        }
+        bitmap_ref atlas = std::make_shared<bitmap_t>(atlas_width, pen_y + height);
+        SDL_Surface* atlas_surface = reinterpret_cast<SDL_Surface*>(atlas->handle());
+        for(Uint16 i=0; i<glyph_count; ++i) {
+            if( nullptr != surfaces[i] ) {
+                if( nullptr != atlas_surface ) {
+                    SDL_Rect dest = f.glyphs[i].src;
+                    SDL_BlitSurface(surfaces[i], nullptr, atlas_surface, &dest);
+                }
+                SDL_FreeSurface(surfaces[i]);
+            }
+        }
+        if( nullptr == atlas_surface ) {
+            return false;
+        }
+        f.atlas = std::make_shared<texture_t>(atlas);
+        if( nullptr == f.atlas->handle() ) {
+            f.atlas = nullptr;
+            return false;
+        }
+        SDL_SetTextureBlendMode(reinterpret_cast<SDL_Texture*>(f.atlas->handle()), SDL_BLENDMODE_BLEND);
+        if( DEBUG_TEX ) {
+            log_printf("glyph atlas: font height %d, %s\n", height, f.atlas->toString().c_str());
+        }
+        return true;
+    }
+}
+
 static void on_window_resized(int wwidth, int wheight) noexcept {
     if( !sdl_rend ) { return; }
+    fb_tiles_flush();
     const int old_fb_width = fb_width;
     const int old_fb_height = fb_height;
     SDL_GetRendererOutputSize(sdl_rend, &fb_width, &fb_height);
 
     if( 0 == wwidth || 0 == wheight ) {
-        SDL_GetWindowSize(sdl_win, &wwidth, &wheight);
+        if( nullptr != sdl_win ) {
+            SDL_GetWindowSize(sdl_win, &wwidth, &wheight);
+        } else {
+            wwidth = fb_width;
+            wheight = fb_height;
+        }
     }
 
     SDL_RendererInfo sdi;
@@ -114,7 +524,7 @@ static void on_window_resized(int wwidth, int wheight) noexcept {
             old_fb_width, old_fb_height, fb_width, fb_height, fb_max_x, fb_max_y);
     win_width = wwidth;
     win_height = wheight;
-    {
+    if( nullptr != sdl_win ) {
         SDL_DisplayMode mode;
         const int win_display_idx = SDL_GetWindowDisplayIndex(sdl_win);
         ::memset(&mode, 0, sizeof(mode));
@@ -130,59 +540,59 @@ static void on_window_resized(int wwidth, int wheight) noexcept {
     fb_pixels_dim_size = (size_t)(fb_width * fb_height);
     fb_pixels_byte_size = fb_pixels_dim_size * 4;
     fb_pixels_byte_width = (size_t)(fb_width * 4);
-    if( nullptr != fb_texture ) {
-        SDL_DestroyTexture( fb_texture );
-        fb_texture = nullptr;
-    }
     if( use_subsys_primitives_val ) {
         printf("SDL-Primitives\n");
     } else {
-        printf("Soft-Primitives: Tex Size %d x %d x 4 = %zu bytes, width %zu bytes\n", fb_width, fb_height, fb_pixels_byte_size, fb_pixels_byte_width);
-        fb_texture = SDL_CreateTexture(sdl_rend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, fb_width, fb_height);
+        printf("Soft-Primitives: Tex Size %d x %d x 4 = %zu bytes, width %zu bytes, streaming %d\n",
+                fb_width, fb_height, fb_pixels_byte_size, fb_pixels_byte_width, fb_streaming_val);
         fb_pixels.reserve(fb_pixels_dim_size);
         fb_pixels.resize(fb_pixels_dim_size);
     }
+    create_fb_texture();
 
-    {
-        if( nullptr != sdl_font ) {
-            TTF_CloseFont(sdl_font);
-            sdl_font = nullptr;
-        }
-        const std::string fontfile = "fonts/freefont/FreeSansBold.ttf";
-        const std::string fontpath = pixel::resolve_asset(fontfile);
-        if( !fontpath.size() ) {
-            log_printf("font: No asset path for font-file '%s' in asset dir '%s'\n", fontfile.c_str(), pixel::asset_dir().c_str());
-            return;
-        }
-        font_height = std::max(24, fb_height / 35);
-        sdl_font = TTF_OpenFont(fontpath.c_str(), font_height);
-        if( nullptr == sdl_font ) {
-            fprintf(stderr, "font: Null font for '%s': %s\n", fontpath.c_str(), SDL_GetError());
-        } else {
-            printf("Using font %s, size %d\n", fontpath.c_str(), font_height);
-        }
+    font_height = std::max(24, fb_height / 35);
+    if( nullptr != get_font(font_height) ) {
+        printf("Using font size %d\n", font_height);
     }
 }
 
 static std::atomic_bool gfx_subsystem_init_called = false;
 static std::atomic_bool gfx_subsystem_init = false;
 
+bool pixel::is_gfx_headless() noexcept {
+    return nullptr != sdl_headless_surface;
+}
+
 bool pixel::is_gfx_subsystem_initialized() noexcept {
     return gfx_subsystem_init;
 }
 
 bool pixel::init_gfx_subsystem(const char* exe_path, const char* title, int wwidth, int wheight, const float origin_norm[2],
-                        bool enable_vsync, bool use_subsys_primitives) {
+                        bool enable_vsync, bool use_subsys_primitives, bool headless) {
     bool exp_init_called = false;
     if( !gfx_subsystem_init_called.compare_exchange_strong(exp_init_called, true) ) {
         return gfx_subsystem_init;
     }
-    lookup_and_register_asset_dir(exe_path);
+    lookup_and_register_asset_dir(exe_path, "fonts/freefont/FreeSansBold.ttf", "gfxbox2", true /* prescan */);
     printf("gfxbox2 version %s\n", pixel::VERSION_LONG);
+    {
+        const char* env_archive = ::getenv("GFXBOX2_ASSET_ARCHIVE");
+        const std::string archive_file = nullptr != env_archive ? std::string(env_archive) : resolve_asset(archive::default_name);
+        if( archive_file.size() ) {
+            open_asset_archive(archive_file);
+        }
+    }
 
     pixel::use_subsys_primitives_val = use_subsys_primitives;
+    {
+        const char* env_headless = ::getenv("GFXBOX2_HEADLESS");
+        if( nullptr != env_headless && 0 != ::atoi(env_headless) ) {
+            headless = true;
+        }
+    }
 
-    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
+    const Uint32 sdl_init_flags = headless ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_EVENTS;
+    if (SDL_Init(sdl_init_flags) != 0) {
         printf("SDL: Error initializing mandatory subsys: %s\n", SDL_GetError());
         return false;
     }
@@ -210,31 +620,48 @@ bool pixel::init_gfx_subsystem(const char* exe_path, const char* title, int wwid
         // override using pre-set default, i.e. set_window_size(..)
         wwidth = win_width; wheight = win_height;
     }
-    sdl_win = SDL_CreateWindow(title,
-            SDL_WINDOWPOS_UNDEFINED,
-            SDL_WINDOWPOS_UNDEFINED,
-            wwidth, wheight,
-            win_flags);
-
-    if (nullptr == sdl_win) {
-        printf("SDL: Error initializing window: %s\n", SDL_GetError());
-        return false;
-    }
+    if( headless ) {
+        sdl_headless_surface = SDL_CreateRGBSurfaceWithFormat(0, wwidth, wheight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (nullptr == sdl_headless_surface) {
+            printf("SDL: Error creating headless surface: %s\n", SDL_GetError());
+            return false;
+        }
+        sdl_rend = SDL_CreateSoftwareRenderer(sdl_headless_surface);
+        if (nullptr == sdl_rend) {
+            printf("SDL: Error creating headless renderer: %s\n", SDL_GetError());
+            SDL_FreeSurface(sdl_headless_surface);
+            sdl_headless_surface = nullptr;
+            return false;
+        }
+        printf("Headless: %s %d x %d\n", title, wwidth, wheight);
+    } else {
+        sdl_win = SDL_CreateWindow(title,
+                SDL_WINDOWPOS_UNDEFINED,
+                SDL_WINDOWPOS_UNDEFINED,
+                wwidth, wheight,
+                win_flags);
+
+        if (nullptr == sdl_win) {
+            printf("SDL: Error initializing window: %s\n", SDL_GetError());
+            return false;
+        }
 
-    Uint32 sdl_win_id = SDL_GetWindowID(sdl_win);
-    if (0 == sdl_win_id) {
-        printf("SDL: Error retrieving window ID: %s\n", SDL_GetError());
-        SDL_DestroyWindow(sdl_win);
-        return false;
-    }
+        Uint32 sdl_win_id = SDL_GetWindowID(sdl_win);
+        if (0 == sdl_win_id) {
+            printf("SDL: Error retrieving window ID: %s\n", SDL_GetError());
+            SDL_DestroyWindow(sdl_win);
+            return false;
+        }
 
-    sdl_rend = SDL_CreateRenderer(sdl_win, -1, render_flags);
-    if (nullptr == sdl_rend) {
-        printf("SDL: Error creating renderer: %s\n", SDL_GetError());
-        SDL_DestroyWindow(sdl_win);
-        return false;
+        sdl_rend = SDL_CreateRenderer(sdl_win, -1, render_flags);
+        if (nullptr == sdl_rend) {
+            printf("SDL: Error creating renderer: %s\n", SDL_GetError());
+            SDL_DestroyWindow(sdl_win);
+            return false;
+        }
     }
 
+    cmd_buf.rend_color_valid = false;
     gpu_frame_count = 0;
     gfx_subsystem_init = true;
 
@@ -260,7 +687,9 @@ extern "C" {
                     win_height = wh;
                 } else {
                     printf("JS Window Resized: Win %d x %d -> %d x %d\n", win_width, win_height, ww, wh);
-                    SDL_SetWindowSize( sdl_win, ww, wh );
+                    if( nullptr != sdl_win ) {
+                        SDL_SetWindowSize( sdl_win, ww, wh );
+                    }
                     warn_once = true;
                     on_window_resized(ww, wh);
                 }
@@ -274,22 +703,76 @@ extern "C" {
 
 void pixel::clear_pixel_fb(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept {
     if( !sdl_rend ) { return; }
-    SDL_SetRenderDrawColor(sdl_rend, r, g, b, a);
+    // pending primitives would be cleared anyways
+    cmd_buf.clear();
+    cmd_buf.color = SDL_Color { r, g, b, a };
+    cmd_apply_color();
     SDL_RenderClear(sdl_rend);
 
-    if( !use_subsys_primitives_val ) {
-        const uint32_t c = rgba_to_uint32(r, g, b, a);
-        size_t count = fb_pixels_dim_size;
-        uint32_t* p = fb_pixels.data();
-        while(count--) { *p++ = c; }
-        // std::fill(p, p+count, c);
-        // ::memset(fb_pixels.data(), 0, fb_pixels_byte_size);
+    if( use_subsys_primitives_val ) {
+        rend_changed = true;
+        return;
+    }
+    fb_begin_frame();
+    const uint32_t c = rgba_to_uint32(r, g, b, a);
+    if( fb_locked ) {
+        // locked texture memory is undefined
+        kernel::fill_rect(fb_data, size_t(fb_stride), size_t(fb_width), size_t(fb_height), c);
+        fb_dirty.clear();
+        fb_drawn.clear();
+        fb_upload.clear();
+        fb_clear_valid = false;
+        return;
+    }
+    if( fb_clear_valid && c == fb_clear_color ) {
+        // only pixels written since the last clear differ from the clear color
+        fb_region_t refill = fb_drawn;
+        refill.add(fb_dirty);
+        if( !refill.empty() ) {
+            kernel::fill_rect(fb_data + ( refill.y1 * fb_stride + refill.x1 ), size_t(fb_stride),
+                              size_t(refill.width()), size_t(refill.height()), c);
+        }
+        fb_upload.add(refill);
+    } else {
+        kernel::fill(fb_pixels.data(), fb_pixels_dim_size, c);
+        fb_upload.set_all();
+        fb_clear_color = c;
+        fb_clear_valid = true;
     }
+    // the refill is uploaded, but not drawn: only software writes after this clear need the next refill
+    fb_dirty.clear();
+    fb_drawn.clear();
+}
+
+pixel::fb_region_t pixel::fb_last_upload() noexcept {
+    return fb_uploaded;
 }
 
 void pixel::swap_pixel_fb(const bool swap_buffer, int fps) noexcept {
+    subsys_flush();
+    fb_tiles_flush();
     if( sdl_rend && !use_subsys_primitives_val ) {
-        SDL_UpdateTexture(fb_texture, nullptr, fb_pixels.data(), (int)fb_pixels_byte_width);
+        fb_uploaded.clear();
+        if( fb_locked ) {
+            unlock_fb_texture();
+            fb_dirty.clear();
+            fb_upload.clear();
+            fb_uploaded.set_all();
+            rend_changed = true;
+        } else {
+            fb_region_t up = fb_upload;
+            up.add(fb_dirty);
+            if( !up.empty() ) {
+                const SDL_Rect r = { .x=up.x1, .y=up.y1, .w=up.width(), .h=up.height() };
+                SDL_UpdateTexture(fb_texture, &r, fb_pixels.data() + ( up.y1 * fb_width + up.x1 ), (int)fb_pixels_byte_width);
+                fb_uploaded = up;
+                rend_changed = true;
+            }
+            // only software writes need a refill at the next clear, not the uploaded refill area
+            fb_drawn.add(fb_dirty);
+            fb_dirty.clear();
+            fb_upload.clear();
+        }
         SDL_RenderCopy(sdl_rend, fb_texture, nullptr, nullptr);
     }
     if( swap_buffer ) {
@@ -298,7 +781,26 @@ void pixel::swap_pixel_fb(const bool swap_buffer, int fps) noexcept {
 }
 void pixel::swap_gpu_buffer(int fps) noexcept {
     if( !sdl_rend ) { return; }
-    SDL_RenderPresent(sdl_rend);
+    subsys_flush();
+    process_asset_uploads();
+    if( nullptr != sdl_headless_surface ) {
+        // unthrottled
+        fps = 0;
+    }
+    if( skip_unchanged_frames_val && !rend_changed ) {
+        // keep pacing without vsync'ed present
+        if( 0 >= fps && nullptr == sdl_headless_surface ) {
+            fps = monitor_frames_per_sec;
+        }
+    } else {
+        SDL_RenderPresent(sdl_rend);
+    }
+    rend_changed = false;
+    cmd_buf.last_stats = cmd_buf.frame_stats;
+    cmd_buf.frame_stats = subsys_batch_stats_t();
+    if( DEBUG_BATCH ) {
+        log_printf("%s\n", cmd_buf.last_stats.toString().c_str());
+    }
     gpu_swap_t0 = jau::getMonotonicTime();
     ++gpu_frame_count;
     constexpr fraction_timespec fps_resync(3, 0); // 3s
@@ -345,7 +847,6 @@ jau::fraction_timespec pixel::gpu_avg_framedur() noexcept {
 //
 // Bitmap
 //
-static constexpr const bool DEBUG_TEX = false;
 
 const char* pixel::bitmap_t::format_str(uint32_t fmt) noexcept {
     const char* s = SDL_GetPixelFormatName(fmt);
@@ -363,15 +864,33 @@ void pixel::bitmap_t::destroy() noexcept {
     }
 }
 
+/**
+ * Returns SDL_RWops of given asset file within the asset archive or the asset directory, or nullptr if not found.
+ * @param location resolved asset location for diagnostics
+ */
+static SDL_RWops* open_asset_rw(const std::string& asset_file, std::string& location) noexcept {
+    const asset_data_t packed = find_archived_asset(asset_file);
+    if( packed.valid() ) {
+        location = asset_archive()+":"+asset_file;
+        return SDL_RWFromConstMem(packed.data, int(packed.size));
+    }
+    location = resolve_asset(asset_file);
+    if( !location.size() ) {
+        log_printf("asset: Could locate file '%s' in asset dir '%s'\n", asset_file.c_str(), asset_dir().c_str());
+        return nullptr;
+    }
+    return SDL_RWFromFile(location.c_str(), "rb");
+}
+
 pixel::bitmap_t::bitmap_t(const std::string& fname0) noexcept
 : m_handle(nullptr), m_pixels(nullptr), width(0), height(0), bpp(0), stride(0), format(0)
 {
-    const std::string fname1 = pixel::resolve_asset(fname0);
-    if( !fname1.size() ) {
-        log_printf("bitmap_t: Could locate file '%s' in asset dir '%s'\n", fname0.c_str(), pixel::asset_dir().c_str());
+    std::string fname1;
+    SDL_RWops* rw = open_asset_rw(fname0, fname1);
+    if( nullptr == rw ) {
         return;
     }
-    SDL_Surface* surface = IMG_Load(fname1.c_str());
+    SDL_Surface* surface = IMG_Load_RW(rw, 1 /* freesrc */);
     if( nullptr == surface ) {
         log_printf("bitmap_t: Error loading %s: %s\n", fname1.c_str(), SDL_GetError());
         return;
@@ -455,6 +974,10 @@ pixel::bitmap_t::bitmap_t(const bitmap_t& o, int /*unused*/) noexcept
 // Texture
 //
 void pixel::texture_t::destroy() noexcept {
+    if( nullptr != m_handle && m_handle == cmd_buf.sprite_tex ) {
+        // pending sprite quads still reference this texture
+        sprite_flush();
+    }
     if( nullptr != m_handle && m_owner ) {
         SDL_Texture* tex = reinterpret_cast<SDL_Texture*>(m_handle);
         SDL_DestroyTexture(tex);
@@ -462,14 +985,43 @@ void pixel::texture_t::destroy() noexcept {
     m_handle = nullptr;
 }
 
+static constexpr uint8_t mul_u8(const uint8_t a, const uint8_t b) noexcept {
+    return uint8_t( ( uint32_t(a) * uint32_t(b) + 127 ) / 255 );
+}
+
+/** Returns given color modulated by the texture's color and alpha modulation */
+static SDL_Color mod_color(const pixel::texture_t& tex, const uint8_t r, const uint8_t g, const uint8_t b, const uint8_t a) noexcept {
+    return SDL_Color { mul_u8(r, tex.mod_r), mul_u8(g, tex.mod_g), mul_u8(b, tex.mod_b), mul_u8(a, tex.mod_a) };
+}
+
 void pixel::texture_t::draw_raw(const uint32_t fb_x, const uint32_t fb_y, const uint32_t fb_w, const uint32_t fb_h) const noexcept {
-    if( sdl_rend && m_handle ) {
-        SDL_Texture* tex = reinterpret_cast<SDL_Texture*>(m_handle);
-        SDL_Rect src = { .x=(int)x, .y=(int)y, .w=(int)width, .h=(int)height};
-        SDL_Rect dest = { .x=(int)fb_x,
-                          .y=(int)fb_y,
-                          .w=(int)fb_w, .h=(int)fb_h };
-        SDL_RenderCopy(sdl_rend, tex, &src, &dest);
+    if( sdl_rend && atlas && atlas->m_handle && !text_glyphs.empty() && 0 < width && 0 < height ) {
+        // text texture: textured glyph quads
+        SDL_Texture* tex = reinterpret_cast<SDL_Texture*>(atlas->m_handle);
+        uint8_t tr, tg, tb, ta;
+        uint32_to_rgba(text_color, tr, tg, tb, ta);
+        const SDL_Color color = mod_color(*this, tr, tg, tb, ta);
+        const float sx = (float)fb_w / (float)width, sy = (float)fb_h / (float)height;
+        for(const text_glyph_t& g : text_glyphs) {
+            const SDL_Rect src = { .x=g.src_x, .y=g.src_y, .w=g.width, .h=g.height };
+            const SDL_FRect dest = { .x=(float)fb_x + (float)g.x * sx, .y=(float)fb_y + (float)g.y * sy,
+                                     .w=(float)g.width * sx, .h=(float)g.height * sy };
+            sprite_enqueue(tex, src, dest, 0.0f, color, blend_mode);
+        }
+    } else if( sdl_rend && m_handle ) {
+        const SDL_Rect src = { .x=(int)x, .y=(int)y, .w=(int)width, .h=(int)height};
+        const SDL_FRect dest = { .x=(float)fb_x, .y=(float)fb_y, .w=(float)fb_w, .h=(float)fb_h };
+        sprite_enqueue(reinterpret_cast<SDL_Texture*>(m_handle), src, dest, 0.0f, SDL_Color { mod_r, mod_g, mod_b, mod_a }, blend_mode);
+    }
+}
+
+void pixel::draw_sprite_fbcoord(const texture_t& tex, float fb_x, float fb_y, float fb_w, float fb_h, float angle_deg,
+                                uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept {
+    void* handle = const_cast<texture_t&>(tex).handle();
+    if( sdl_rend && nullptr != handle ) {
+        const SDL_Rect src = { .x=(int)tex.x, .y=(int)tex.y, .w=(int)tex.width, .h=(int)tex.height};
+        const SDL_FRect dest = { .x=fb_x, .y=fb_y, .w=fb_w, .h=fb_h };
+        sprite_enqueue(reinterpret_cast<SDL_Texture*>(handle), src, dest, angle_deg, mod_color(tex, r, g, b, a), tex.blend_mode);
     }
 }
 
@@ -511,12 +1063,12 @@ pixel::texture_t::texture_t(const std::string& fname0) noexcept
 : m_handle(nullptr), m_owner(false), x(0), y(0), width(0), height(0), bpp(0), format(0), dest_x(0), dest_y(0), dest_sx(1), dest_sy(1)
 {
     if( !sdl_rend ) { return; }
-    const std::string fname1 = pixel::resolve_asset(fname0);
-    if( !fname1.size() ) {
-        log_printf("texture_t: Could locate file '%s' in asset dir '%s'\n", fname0.c_str(), pixel::asset_dir().c_str());
+    std::string fname1;
+    SDL_RWops* rw = open_asset_rw(fname0, fname1);
+    if( nullptr == rw ) {
         return;
     }
-    SDL_Texture* tex_ = IMG_LoadTexture(sdl_rend, fname1.c_str());
+    SDL_Texture* tex_ = IMG_LoadTexture_RW(sdl_rend, rw, 1 /* freesrc */);
     if( nullptr == tex_ ) {
         log_printf("texture_t: Error loading %s: %s\n", fname1.c_str(), SDL_GetError());
     }
@@ -542,52 +1094,422 @@ void pixel::texture_t::update(const bitmap_ref& bmap) noexcept {
         return;
     }
     SDL_Texture* tex = reinterpret_cast<SDL_Texture*>(m_handle);
+    if( tex == cmd_buf.sprite_tex ) {
+        // pending sprite quads were drawn with the previous content
+        sprite_flush();
+    }
     SDL_Rect rect { 0, 0, (int)bmap->width, (int)bmap->height};
     if( SDL_UpdateTexture(tex, &rect, bmap->pixels(), (int)bmap->stride) ) {
         log_printf("texture_t: Update error: %s\n", SDL_GetError());
     }
 }
 
+//
+// Texture Atlas
+//
+
+bool pixel::tex_atlas_t::add_page(const uint32_t width, const uint32_t height) noexcept {
+    SDL_Texture* tex = SDL_CreateTexture(sdl_rend, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, (int)width, (int)height);
+    if( nullptr == tex ) {
+        log_printf("tex_atlas_t: Error creating page %u x %u: %s\n", width, height, SDL_GetError());
+        return false;
+    }
+    // static texture memory is undefined, clear padding between packed bitmaps
+    {
+        const std::vector<uint32_t> zero(size_t(width) * height, 0);
+        SDL_UpdateTexture(tex, nullptr, zero.data(), (int)( width * 4 ));
+    }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    texture_ref page = std::make_shared<texture_t>(reinterpret_cast<void*>(tex), 0, 0, width, height, 4, SDL_PIXELFORMAT_ABGR8888);
+    m_pages.push_back( page_t { page, { skyline_t { 0, 0, width } } } );
+    if( DEBUG_TEX ) {
+        log_printf("tex_atlas_t: Added page %zu: %s\n", m_pages.size() - 1, page->toString().c_str());
+    }
+    return true;
+}
+
+bool pixel::tex_atlas_t::pack(page_t& page, const uint32_t w, const uint32_t h, uint32_t& x, uint32_t& y) noexcept {
+    std::vector<skyline_t>& sky = page.skyline;
+    const uint32_t page_width = page.tex->width, page_height = page.tex->height;
+    // bottom-left: lowest resulting top y, then narrowest segment
+    size_t best_i = sky.size();
+    uint32_t best_y = std::numeric_limits<uint32_t>::max(), best_w = 0;
+    for(size_t i=0; i<sky.size(); ++i) {
+        if( sky[i].x + w > page_width ) {
+            break;
+        }
+        uint32_t top = 0;
+        int64_t width_left = w;
+        for(size_t j=i; 0 < width_left; ++j) {
+            top = std::max(top, sky[j].y);
+            width_left -= sky[j].width;
+        }
+        if( top + h <= page_height && ( top < best_y || ( top == best_y && sky[i].width < best_w ) ) ) {
+            best_i = i;
+            best_y = top;
+            best_w = sky[i].width;
+        }
+    }
+    if( best_i == sky.size() ) {
+        return false;
+    }
+    x = sky[best_i].x;
+    y = best_y;
+    // raise the covered skyline to y + h
+    sky.insert(sky.begin() + ptrdiff_t(best_i), skyline_t { x, y + h, w });
+    for(size_t j = best_i + 1; j < sky.size(); ) {
+        const uint32_t end = sky[j-1].x + sky[j-1].width;
+        if( sky[j].x >= end ) {
+            break;
+        }
+        const uint32_t shrink = end - sky[j].x;
+        if( shrink >= sky[j].width ) {
+            sky.erase(sky.begin() + ptrdiff_t(j));
+        } else {
+            sky[j].x += shrink;
+            sky[j].width -= shrink;
+            break;
+        }
+    }
+    // merge neighbors at equal height
+    for(size_t j = 1; j < sky.size(); ) {
+        if( sky[j-1].y == sky[j].y ) {
+            sky[j-1].width += sky[j].width;
+            sky.erase(sky.begin() + ptrdiff_t(j));
+        } else {
+            ++j;
+        }
+    }
+    return true;
+}
+
+pixel::tex_atlas_sub_t pixel::tex_atlas_t::add(const bitmap_ref& bmap) noexcept {
+    SDL_Surface* surface = nullptr != bmap ? reinterpret_cast<SDL_Surface*>(bmap->handle()) : nullptr;
+    if( !sdl_rend || nullptr == surface || SDL_PIXELFORMAT_ABGR8888 != bmap->format ) {
+        log_printf("tex_atlas_t: Invalid bitmap %s\n", nullptr != bmap ? bmap->toString().c_str() : "null");
+        return tex_atlas_sub_t { 0, 0, 0, 0, 0 };
+    }
+    // 1 pixel padding to avoid bleeding of filtered neighbors
+    const uint32_t w = bmap->width + 1, h = bmap->height + 1;
+    uint32_t x = 0, y = 0;
+    size_t p = 0;
+    while( p < m_pages.size() && !pack(m_pages[p], w, h, x, y) ) {
+        ++p;
+    }
+    if( p == m_pages.size() ) {
+        if( !add_page(std::max(m_page_width, w), std::max(m_page_height, h)) || !pack(m_pages[p], w, h, x, y) ) {
+            return tex_atlas_sub_t { 0, 0, 0, 0, 0 };
+        }
+    }
+    const texture_ref& page = m_pages[p].tex;
+    const SDL_Rect rect { (int)x, (int)y, (int)bmap->width, (int)bmap->height };
+    if( SDL_UpdateTexture(reinterpret_cast<SDL_Texture*>(page->handle()), &rect, bmap->pixels(), (int)bmap->stride) ) {
+        log_printf("tex_atlas_t: Update error: %s\n", SDL_GetError());
+    }
+    const tex_atlas_sub_t sub { (uint32_t)p, rect.x, rect.y, rect.w, rect.h };
+    if( DEBUG_TEX ) {
+        log_printf("tex_atlas_t: Packed page %zu: %d/%d %dx%d\n", p, sub.x, sub.y, sub.width, sub.height);
+    }
+    return sub;
+}
+
+pixel::tex_atlas_sub_t pixel::tex_atlas_t::add(const std::string& fname) noexcept {
+    return add( std::make_shared<bitmap_t>(fname) );
+}
+
+pixel::texture_ref pixel::tex_atlas_t::texture(const tex_atlas_sub_t& sub) const noexcept {
+    if( !sub.valid() || sub.page >= m_pages.size() ) {
+        return nullptr;
+    }
+    const texture_ref& page = m_pages[sub.page].tex;
+    texture_ref tex = std::make_shared<texture_t>(page->handle(), (uint32_t)sub.x, (uint32_t)sub.y, (uint32_t)sub.width, (uint32_t)sub.height,
+                                                  page->bpp, page->format, false /* owner*/);
+    tex->atlas = page;
+    return tex;
+}
+
+void pixel::tex_atlas_t::draw_fbcoord(const tex_atlas_sub_t& sub, float fb_x, float fb_y, float fb_w, float fb_h, float angle_deg) const noexcept {
+    if( sdl_rend && sub.valid() && sub.page < m_pages.size() ) {
+        const SDL_Rect src = { .x=sub.x, .y=sub.y, .w=sub.width, .h=sub.height };
+        const SDL_FRect dest = { .x=fb_x, .y=fb_y, .w=fb_w, .h=fb_h };
+        sprite_enqueue(reinterpret_cast<SDL_Texture*>(m_pages[sub.page].tex->handle()), src, dest, angle_deg, SDL_Color { 255, 255, 255, 255 });
+    }
+}
+
+std::string pixel::tex_atlas_t::toString() const noexcept {
+    std::string s = "tex_atlas[pages "+std::to_string(m_pages.size());
+    for(const page_t& p : m_pages) {
+        s += ", "+std::to_string(p.tex->width)+"x"+std::to_string(p.tex->height)+" skyline "+std::to_string(p.skyline.size());
+    }
+    return s+"]";
+}
+
+pixel::tex_atlas_t& pixel::default_tex_atlas() noexcept {
+    static tex_atlas_t atlas;
+    return atlas;
+}
+
+//
+// Asset Loader
+//
+
+namespace {
+    /** Worker threads decoding assets off the render thread, started on first use */
+    class asset_loader_t {
+        private:
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::deque<std::function<void()>> jobs;
+            std::vector<std::thread> workers;
+            bool stopping = false;
+            /** Render thread jobs of decoded assets, i.e. texture creation */
+            std::mutex upload_mtx;
+            std::vector<std::function<void()>> uploads;
+            std::mutex timing_mtx;
+            std::vector<pixel::asset_timing_t> timings;
+
+            void run() noexcept {
+                for(;;) {
+                    std::function<void()> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mtx);
+                        cv.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                        if( stopping ) {
+                            return;
+                        }
+                        job = std::move(jobs.front());
+                        jobs.pop_front();
+                    }
+                    job();
+                }
+            }
+
+        public:
+#if defined(__EMSCRIPTEN__)
+            unsigned thread_count = 0;
+#else
+            unsigned thread_count = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
+#endif
+
+            // at exit nobody awaits the futures anymore, while decoders may already be shut down
+            ~asset_loader_t() noexcept { stop(false); }
+
+            /**
+             * Stops all workers.
+             *
+             * If drain is true, pending jobs are run on the calling thread so their futures get resolved,
+             * otherwise they are discarded and their futures get broken.
+             */
+            void stop(const bool drain=true) noexcept {
+                std::deque<std::function<void()>> pending;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    stopping = true;
+                    pending.swap(jobs);
+                }
+                cv.notify_all();
+                for(std::thread& t : workers) {
+                    t.join();
+                }
+                workers.clear();
+                stopping = false;
+                if( drain ) {
+                    for(std::function<void()>& job : pending) {
+                        job();
+                    }
+                }
+            }
+
+            void submit(std::function<void()> job) noexcept {
+                if( 0 == thread_count ) {
+                    job();
+                    return;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    if( workers.empty() ) {
+                        for(unsigned i=0; i<thread_count; ++i) {
+                            workers.emplace_back([this]() { run(); });
+                        }
+                    }
+                    jobs.push_back(std::move(job));
+                }
+                cv.notify_one();
+            }
+
+            void post_upload(std::function<void()> job) noexcept {
+                std::unique_lock<std::mutex> lock(upload_mtx);
+                uploads.push_back(std::move(job));
+            }
+
+            size_t process_uploads() noexcept {
+                std::vector<std::function<void()>> pending;
+                {
+                    std::unique_lock<std::mutex> lock(upload_mtx);
+                    pending.swap(uploads);
+                }
+                for(std::function<void()>& job : pending) {
+                    job();
+                }
+                return pending.size();
+            }
+
+            void add_timing(const std::string& name, const fraction_timespec& decode, const fraction_timespec& total) noexcept {
+                pixel::asset_timing_t t { .name=name, .decode_us=(uint64_t)decode.to_us(), .total_us=(uint64_t)total.to_us() };
+                if( DEBUG_TEX ) {
+                    log_printf("asset_loader: %s\n", t.toString().c_str());
+                }
+                std::unique_lock<std::mutex> lock(timing_mtx);
+                timings.push_back(std::move(t));
+            }
+
+            std::vector<pixel::asset_timing_t> get_timings() noexcept {
+                std::unique_lock<std::mutex> lock(timing_mtx);
+                return timings;
+            }
+
+            void clear_timings() noexcept {
+                std::unique_lock<std::mutex> lock(timing_mtx);
+                timings.clear();
+            }
+    };
+}
+static asset_loader_t asset_loader;
+
+std::string pixel::asset_timing_t::toString() const noexcept {
+    return name+": decode "+std::to_string(double(decode_us)/1000.0)+" ms, total "+std::to_string(double(total_us)/1000.0)+" ms";
+}
+
+void pixel::set_asset_loader_threads(unsigned threads) noexcept {
+    asset_loader.stop();
+    asset_loader.thread_count = threads;
+}
+
+unsigned pixel::asset_loader_threads() noexcept { return asset_loader.thread_count; }
+
+void pixel::asset_loader_submit(const std::string& name, std::function<void()> job) noexcept {
+    const fraction_timespec t0 = getMonotonicTime();
+    asset_loader.submit([name, job=std::move(job), t0]() {
+        const fraction_timespec t1 = getMonotonicTime();
+        job();
+        const fraction_timespec t2 = getMonotonicTime();
+        asset_loader.add_timing(name, t2 - t1, t2 - t0);
+    });
+}
+
+pixel::bitmap_future pixel::load_bitmap_async(const std::string& fname) noexcept {
+    std::shared_ptr<std::promise<bitmap_ref>> res = std::make_shared<std::promise<bitmap_ref>>();
+    bitmap_future f = res->get_future().share();
+    asset_loader_submit(fname, [res, fname]() {
+        res->set_value( std::make_shared<bitmap_t>(fname) );
+    });
+    return f;
+}
+
+pixel::texture_future pixel::load_texture_async(const std::string& fname) noexcept {
+    std::shared_ptr<std::promise<texture_ref>> res = std::make_shared<std::promise<texture_ref>>();
+    texture_future f = res->get_future().share();
+    const fraction_timespec t0 = getMonotonicTime();
+    asset_loader.submit([res, fname, t0]() {
+        const fraction_timespec t1 = getMonotonicTime();
+        bitmap_ref bmp = std::make_shared<bitmap_t>(fname);
+        const fraction_timespec td_decode = getMonotonicTime() - t1;
+        asset_loader.post_upload([res, fname, t0, td_decode, bmp=std::move(bmp)]() {
+            texture_ref tex = nullptr != bmp->handle() ? std::make_shared<texture_t>(bmp) : std::make_shared<texture_t>();
+            asset_loader.add_timing(fname, td_decode, getMonotonicTime() - t0);
+            res->set_value( std::move(tex) );
+        });
+    });
+    return f;
+}
+
+size_t pixel::process_asset_uploads() noexcept {
+    return asset_loader.process_uploads();
+}
+
+pixel::texture_ref pixel::await_texture(const texture_future& f) noexcept {
+    if( !f.valid() ) {
+        return nullptr;
+    }
+    while( true ) {
+        process_asset_uploads();
+        if( std::future_status::ready == f.wait_for(std::chrono::milliseconds(1)) ) {
+            return f.get();
+        }
+    }
+}
+
+std::vector<pixel::asset_timing_t> pixel::asset_load_timings() noexcept {
+    return asset_loader.get_timings();
+}
+
+void pixel::clear_asset_load_timings() noexcept {
+    asset_loader.clear_timings();
+}
+
 //
 // Text Texture
 //
 
 static bool _tex_font_warn0_once = true;
 static bool _tex_font_warn1_once = true;
-pixel::texture_ref pixel::make_text(const std::string& text) noexcept
+pixel::texture_ref pixel::make_text(const std::string& text) noexcept {
+    return make_text(font_height, text);
+}
+
+pixel::texture_ref pixel::make_text(const int font_size, const std::string& text) noexcept
 {
-    if( !sdl_rend || !sdl_font ) {
+    font_entry_t* f = nullptr != sdl_rend ? get_font(font_size) : nullptr;
+    if( nullptr == f ) {
         if( _tex_font_warn0_once ) {
             fprintf(stderr, "make_text_texture: Null texture for '%s': Uninitialized %s\n", text.c_str(),
-                !sdl_font ? "font" : "renderer");
+                !sdl_rend ? "renderer" : "font");
             _tex_font_warn0_once = false;
         }
         return std::make_shared<texture_t>();
     }
-    uint8_t r, g, b, a;
-    pixel::uint32_to_rgba(draw_color, r, g, b, a);
-    SDL_Color foregroundColor = { r, g, b, a };
-
-    SDL_Surface* textSurface = TTF_RenderText_Solid(sdl_font, text.c_str(), foregroundColor);
-    if( nullptr == textSurface ) {
+    if( !f->atlas && !build_glyph_atlas(*f) ) {
         if( _tex_font_warn1_once ) {
             fprintf(stderr, "make_text_texture: Null texture for '%s': %s\n", text.c_str(), SDL_GetError());
             _tex_font_warn1_once = false;
         }
         return std::make_shared<texture_t>();
     }
-    SDL_Texture* sdl_tex = SDL_CreateTextureFromSurface(sdl_rend, textSurface);
-    texture_ref tex = std::make_shared<texture_t>(reinterpret_cast<void*>(sdl_tex), 0, 0, 0, 0, 0, 0);
-    {
-        Uint32 format_ = 0;
-        int w=0, h=0;
-        SDL_QueryTexture(sdl_tex, &format_, nullptr, &w, &h);
-        tex->width = w;
-        tex->height = h;
-        tex->bpp = SDL_BYTESPERPIXEL(format_);
-        tex->format = format_;
+    texture_ref tex = std::make_shared<texture_t>();
+    tex->atlas = f->atlas;
+    tex->text_color = draw_color;
+    tex->text_glyphs.reserve(text.size());
+    // lay out glyphs like TTF_RenderText_Solid, including kerning
+    int pen = 0, x_min = 0, x_max = 0;
+    Uint16 prev = 0;
+    for(const char c : text) {
+        const Uint16 ch = static_cast<unsigned char>(c);
+        if( ch < glyph_first ) {
+            continue;
+        }
+        const atlas_glyph_t& g = f->glyphs[ch - glyph_first];
+        if( 0 != prev ) {
+            pen += TTF_GetFontKerningSizeGlyphs(f->font, prev, ch);
+        }
+        if( 0 < g.src.w ) {
+            const int x = pen + g.dx;
+            tex->text_glyphs.push_back( { uint16_t(g.src.x), uint16_t(g.src.y), uint16_t(g.src.w), uint16_t(g.src.h), x, 0 } );
+            x_min = std::min(x_min, x);
+            x_max = std::max(x_max, x + g.src.w);
+        }
+        pen += g.advance;
+        x_max = std::max(x_max, pen);
+        prev = ch;
+    }
+    if( 0 > x_min ) {
+        for(text_glyph_t& g : tex->text_glyphs) {
+            g.x -= x_min;
+        }
     }
-    SDL_FreeSurface(textSurface);
+    tex->width = uint32_t(x_max - x_min);
+    tex->height = uint32_t(TTF_FontHeight(f->font));
+    tex->bpp = f->atlas->bpp;
+    tex->format = f->atlas->format;
     return tex;
 }
 
@@ -596,33 +1518,115 @@ pixel::texture_ref pixel::make_text(const std::string& text) noexcept
 // Primitives
 //
 
+void pixel::subsys_flush() noexcept {
+    if( !sdl_rend ) {
+        cmd_buf.clear();
+        return;
+    }
+    sprite_flush();
+    if( cmd_buf.empty() ) {
+        return;
+    }
+    subsys_batch_stats_t& stats = cmd_buf.frame_stats;
+    rend_changed = true;
+    cmd_apply_color();
+    if( !cmd_buf.points.empty() ) {
+        SDL_RenderDrawPoints(sdl_rend, cmd_buf.points.data(), int(cmd_buf.points.size()));
+        ++stats.submitted;
+    }
+    for(size_t i=0; i<cmd_buf.line_chains.size(); ++i) {
+        const size_t start = cmd_buf.line_chains[i];
+        const size_t end = i+1 < cmd_buf.line_chains.size() ? cmd_buf.line_chains[i+1] : cmd_buf.lines.size();
+        SDL_RenderDrawLines(sdl_rend, cmd_buf.lines.data() + start, int(end - start));
+        ++stats.submitted;
+    }
+    if( !cmd_buf.fill_rects.empty() ) {
+        SDL_RenderFillRects(sdl_rend, cmd_buf.fill_rects.data(), int(cmd_buf.fill_rects.size()));
+        ++stats.submitted;
+    }
+    if( !cmd_buf.draw_rects.empty() ) {
+        SDL_RenderDrawRects(sdl_rend, cmd_buf.draw_rects.data(), int(cmd_buf.draw_rects.size()));
+        ++stats.submitted;
+    }
+    cmd_buf.clear();
+}
+
+pixel::subsys_batch_stats_t pixel::subsys_batch_stats() noexcept {
+    return cmd_buf.last_stats;
+}
+
 void pixel::subsys_set_pixel_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept {
-    if( sdl_rend ) {
-        SDL_SetRenderDrawColor(sdl_rend, r, g, b, a);
+    const SDL_Color c { r, g, b, a };
+    ++cmd_buf.frame_stats.recorded;
+    if( !( c == cmd_buf.color ) ) {
+        // pending sprites don't depend on the draw color
+        if( !cmd_buf.empty() ) {
+            subsys_flush();
+        }
+        cmd_buf.color = c;
     }
 }
 
 void pixel::subsys_draw_pixel(int x, int y) noexcept {
-    if( sdl_rend ) {
-        SDL_RenderDrawPoint(sdl_rend, x, y);
-    }
+    cmd_record();
+    cmd_buf.points.push_back( SDL_Point { x, y } );
 }
 
 void pixel::subsys_draw_line(int x1, int y1, int x2, int y2) noexcept {
-    if( sdl_rend ) {
-       SDL_RenderDrawLine(sdl_rend, x1, y1, x2, y2);
+    cmd_record();
+    if( !cmd_buf.lines.empty() && cmd_buf.lines.back().x == x1 && cmd_buf.lines.back().y == y1 ) {
+        // continue current poly-line chain
+        cmd_buf.lines.push_back( SDL_Point { x2, y2 } );
+    } else if( y1 == y2 ) {
+        cmd_buf.fill_rects.push_back( SDL_Rect { .x=std::min(x1, x2), .y=y1, .w=std::abs(x2 - x1) + 1, .h=1 } );
+    } else if( x1 == x2 ) {
+        cmd_buf.fill_rects.push_back( SDL_Rect { .x=x1, .y=std::min(y1, y2), .w=1, .h=std::abs(y2 - y1) + 1 } );
+    } else {
+        cmd_buf.line_chains.push_back( cmd_buf.lines.size() );
+        cmd_buf.lines.push_back( SDL_Point { x1, y1 } );
+        cmd_buf.lines.push_back( SDL_Point { x2, y2 } );
     }
 }
 
 void pixel::subsys_draw_box(bool filled, int x, int y, int width, int height) noexcept
 {
-    if( sdl_rend ) {
-       SDL_Rect bounds = { .x=x, .y=y, .w=width, .h=height };
-       if( filled ) {
-           SDL_RenderFillRect(sdl_rend, &bounds);
-       } else {
-           SDL_RenderDrawRect(sdl_rend, &bounds);
-       }
+    cmd_record();
+    const SDL_Rect bounds = { .x=x, .y=y, .w=width, .h=height };
+    if( filled ) {
+        cmd_buf.fill_rects.push_back( bounds );
+    } else {
+        cmd_buf.draw_rects.push_back( bounds );
+    }
+}
+
+void pixel::subsys_draw_spans(const fb_span_t* spans, size_t count) noexcept
+{
+    cmd_record();
+    for(size_t i=0; i<count; ++i) {
+        const fb_span_t& s = spans[i];
+        cmd_buf.fill_rects.push_back( SDL_Rect { .x=s.x1, .y=s.y, .w=s.x2 - s.x1 + 1, .h=1 } );
+    }
+}
+
+void pixel::subsys_fill_triangles(const fb_vertex_t* vertices, size_t count) noexcept
+{
+    ++cmd_buf.frame_stats.recorded;
+    if( !sdl_rend || 3 > count ) {
+        return;
+    }
+    subsys_flush();
+    const SDL_Color color = cmd_buf.color;
+    static std::vector<SDL_Vertex> sdl_vertices;
+    sdl_vertices.clear();
+    sdl_vertices.reserve(count);
+    for(size_t i=0; i<count; ++i) {
+        sdl_vertices.push_back( SDL_Vertex { .position={ vertices[i].x, vertices[i].y }, .color=color, .tex_coord={ 0.0f, 0.0f } } );
+    }
+    const int err = SDL_RenderGeometry(sdl_rend, nullptr, sdl_vertices.data(), int(count - count % 3), nullptr, 0);
+    ++cmd_buf.frame_stats.submitted;
+    rend_changed = true;
+    if( 0 != err ) {
+        log_printf("SDL_RenderGeometry: %zu vertices, err %d, %s\n", count, err, SDL_GetError());
     }
 }
 
@@ -631,46 +1635,33 @@ void pixel::subsys_draw_line(int thickness, int x1, int y1, int x2, int y2) noex
     if( !sdl_rend || 0 >= thickness ) {
         return;
     }
-    const int x1_i = x1;
-    const int y1_i = y1;
-    const int x2_i = x2;
-    const int y2_i = y2;
-    const int d_extra = thickness - 1;
-    if( 0 == d_extra ) {
-        SDL_RenderDrawLine(sdl_rend, x1_i, y1_i, x2_i, y2_i);
+    if( 1 == thickness ) {
+        subsys_draw_line(x1, y1, x2, y2);
         return;
     }
-    const float d_x = float(std::abs( x1_i - x2_i ));
-    const float d_y = float(std::abs( y1_i - y2_i ));
-
-    // Create a polygon of connected dots, aka poly-line
-    const int c_l = -1 * ( d_extra / 2 + d_extra % 2 ); // gets the remainder
-    const int c_r =        d_extra / 2;
-    std::vector<SDL_Point> points;
-    bool first_of_two = true;
-    for(int i=c_l; i<=c_r; ++i) {
-        int ix, iy; // rough and simply thickness delta picking
-        if( d_y > d_x ) {
-            ix = i;
-            iy = 0;
-        } else {
-            ix = 0;
-            iy = i;
-        }
-        if( first_of_two ) {
-            points.push_back( SDL_Point { x1_i+ix, y1_i+iy } );
-            points.push_back( SDL_Point { x2_i+ix, y2_i+iy } );
-            first_of_two = false;
-        } else {
-            points.push_back( SDL_Point { x2_i+ix, y2_i+iy } );
-            points.push_back( SDL_Point { x1_i+ix, y1_i+iy } );
-            first_of_two = true;
-        }
-    }
-    const int err = SDL_RenderDrawLines(sdl_rend, points.data(), int(points.size()));
-    if( false ) {
-        log_printf("Poly-Line thick_p %d, %d lines, d %.4f/%.4f, err %d, %s\n", thickness, points.size()/2, d_x, d_y, err, SDL_GetError());
+    // Tessellate the thick line into a quad of two triangles,
+    // extending the end points by half the thickness along the line.
+    const float half = float(thickness) / 2.0f;
+    float d_x = float(x2 - x1);
+    float d_y = float(y2 - y1);
+    const float len = std::sqrt( d_x*d_x + d_y*d_y );
+    if( 0.0f == len ) {
+        d_x = 1.0f;
+        d_y = 0.0f;
+    } else {
+        d_x /= len;
+        d_y /= len;
     }
+    const float u_x = d_x * half, u_y = d_y * half; // along the line
+    const float n_x = -u_y,       n_y = u_x;        // normal
+    const float ax = float(x1) + 0.5f - u_x, ay = float(y1) + 0.5f - u_y;
+    const float bx = float(x2) + 0.5f + u_x, by = float(y2) + 0.5f + u_y;
+    const fb_vertex_t p0 { ax + n_x, ay + n_y };
+    const fb_vertex_t p1 { bx + n_x, by + n_y };
+    const fb_vertex_t p2 { bx - n_x, by - n_y };
+    const fb_vertex_t p3 { ax - n_x, ay - n_y };
+    const fb_vertex_t v[] = { p0, p1, p2, p0, p2, p3 };
+    subsys_fill_triangles(v, 6);
 }
 
 
@@ -912,6 +1903,7 @@ bool pixel::handle_one_event(input_event_t& event) noexcept {
     void pixel::save_snapshot(const std::string& fname) noexcept {
         SDL_Surface *sshot = SDL_CreateRGBSurface(0, fb_width, fb_height, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
         SDL_LockSurface(sshot);
+        subsys_flush();
         SDL_RenderReadPixels(sdl_rend, nullptr, SDL_PIXELFORMAT_ARGB8888, sshot->pixels, sshot->pitch);
         char * fname2 = strdup(fname.c_str());
         std::thread t(&store_surface, sshot, fname2);
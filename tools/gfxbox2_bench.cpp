@@ -0,0 +1,372 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Microbenchmarks of the library's hot paths, printing the throughput per benchmark.
+ *
+ * Usage: gfxbox2_bench [section...], running all sections if none given.
+ * Returns a non-zero exit code if a section's result check fails.
+ */
+#include "pixel/pixel.hpp"
+#include "pixel/kernel.hpp"
+#include "pixel/pixel2f.hpp"
+#include "pixel/pixel2i.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pixel;
+
+static const char* bench_exe = "gfxbox2_bench";
+
+/** Sink for benchmark results, keeping the compiler from eliding the measured calls. */
+static volatile uint64_t bench_sink = 0;
+
+/** Repeats f() for at least min_ms milliseconds, returns the mean duration of one call in nanoseconds. */
+template<typename F>
+static double bench_ns(F&& f, const double min_ms=200.0) {
+    typedef std::chrono::steady_clock steady_clock_t;
+    f(); // warm-up
+    size_t n = 0;
+    const steady_clock_t::time_point t0 = steady_clock_t::now();
+    double ms = 0;
+    do {
+        f();
+        ++n;
+        ms = std::chrono::duration<double, std::milli>(steady_clock_t::now() - t0).count();
+    } while( ms < min_ms );
+    return ms * 1e6 / double(n);
+}
+
+/** Initializes the headless software framebuffer once, returns false on failure. */
+static bool bench_init_gfx(const char* section) {
+    const float origin_norm[] = { 0.5f, 0.5f };
+    if( !pixel::is_gfx_headless() &&
+        !pixel::init_gfx_subsystem(bench_exe, "gfxbox2_bench", 1280, 720, origin_norm, false, false /* software primitives */, true /* headless */) ) {
+        fprintf(stderr, "%s: init_gfx_subsystem failed\n", section);
+        return false;
+    }
+    return true;
+}
+
+//
+// kernels
+//
+
+static bool bench_kernels() {
+    constexpr size_t w = 1920, h = 1080, count = w * h;
+    constexpr size_t rw = 1280, rh = 720;
+    std::vector<uint32_t> dst(count, 0xff102030), src(count);
+    for(size_t i=0; i<count; ++i) {
+        src[i] = uint32_t(i * 2654435761u) | ( i & 1 ? 0xff000000 : 0 );
+    }
+    printf("kernels: %zux%zu pixel, fill_rect %zux%zu, detected %s\n", w, h, rw, rh, kernel::to_string(kernel::isa()));
+    printf("  %-8s %12s %12s %12s %12s %12s   [Mpixel/s]\n", "isa", "fill", "fill_rect", "blend", "blend_over", "equals");
+    const kernel::isa_t detected = kernel::isa();
+    for(const kernel::isa_t isa : { kernel::isa_t::scalar, kernel::isa_t::sse2, kernel::isa_t::avx2 }) {
+        if( !kernel::set_isa(isa) ) {
+            printf("  %-8s unsupported\n", kernel::to_string(isa));
+            continue;
+        }
+        const double t_fill = bench_ns([&]() { kernel::fill(dst.data(), count, 0xff405060); });
+        const double t_rect = bench_ns([&]() { kernel::fill_rect(dst.data(), w, rw, rh, 0xff405060); });
+        const double t_blend = bench_ns([&]() { kernel::blend(dst.data(), count, 0x80a0b0c0); });
+        const double t_over = bench_ns([&]() { kernel::blend_over(dst.data(), src.data(), count); });
+        kernel::fill(dst.data(), count, 0xff405060);
+        const double t_eq = bench_ns([&]() { bench_sink = bench_sink + kernel::equals(dst.data(), count, 0xff405060); });
+        auto mpix = [](const size_t pixel, const double ns) { return double(pixel) * 1e3 / ns; };
+        printf("  %-8s %12.1f %12.1f %12.1f %12.1f %12.1f\n", kernel::to_string(isa),
+               mpix(count, t_fill), mpix(rw * rh, t_rect), mpix(count, t_blend), mpix(count, t_over), mpix(count, t_eq));
+    }
+    kernel::set_isa(detected);
+    return true;
+}
+
+//
+// fb: partial clear and upload of software frames
+//
+
+static bool bench_fb() {
+    constexpr int sw = 32, sh = 32;
+    if( !bench_init_gfx("fb") ) {
+        return false;
+    }
+    // static scene of one moving sprite: after the second frame, only the old and new sprite area may be uploaded
+    bool ok = true;
+    int prev_x = -1;
+    uint64_t uploaded = 0;
+    auto frame = [&](const int f, const uint8_t clear_lum, const bool check) {
+        const int x = ( f * 3 ) % ( pixel::fb_width - sw ), y = pixel::fb_height / 2;
+        pixel::clear_pixel_fb(clear_lum, clear_lum, clear_lum, 255);
+        kernel::fill_rect(pixel::fb_data + ( y * pixel::fb_stride + x ), size_t(pixel::fb_stride), sw, sh, 0xffff0000);
+        pixel::fb_dirty.add(x, y, x + sw - 1, y + sh - 1);
+        pixel::swap_pixel_fb(true, 0);
+        const pixel::fb_region_t up = pixel::fb_last_upload();
+        uploaded += uint64_t(up.width()) * uint64_t(up.height());
+        if( check && f >= 2 ) {
+            pixel::fb_region_t expected;
+            expected.add(prev_x, y, prev_x + sw - 1, y + sh - 1);
+            expected.add(x, y, x + sw - 1, y + sh - 1);
+            if( up.x1 != expected.x1 || up.y1 != expected.y1 || up.x2 != expected.x2 || up.y2 != expected.y2 ) {
+                if( ok ) {
+                    fprintf(stderr, "fb: frame %d uploaded %s, expected %s\n", f, up.toString().c_str(), expected.toString().c_str());
+                }
+                ok = false;
+            }
+        }
+        prev_x = x;
+    };
+    int f = 0;
+    const double t_partial = bench_ns([&]() { frame(f, 0, true); ++f; });
+    const int partial_frames = f;
+    const uint64_t partial_px = uploaded / uint64_t(f);
+    uploaded = 0;
+    f = 0;
+    // alternating clear color defeats the partial clear
+    const double t_full = bench_ns([&]() { frame(f, uint8_t(f & 1), false); ++f; });
+    const uint64_t full_px = uploaded / uint64_t(f);
+    printf("fb: %dx%d, sprite %dx%d moving, %d frames\n", pixel::fb_width, pixel::fb_height, sw, sh, partial_frames);
+    printf("  partial clear/upload %10.1f us/frame, %8" PRIu64 " pixel uploaded/frame\n", t_partial / 1e3, partial_px);
+    printf("  full clear/upload    %10.1f us/frame, %8" PRIu64 " pixel uploaded/frame\n", t_full / 1e3, full_px);
+    printf("  upload region check: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+//
+// tiled: tile-binned rasterizer threads vs immediate software rasterizer
+//
+
+static bool bench_tiled() {
+    constexpr size_t disks = 4000, triangles = 4000;
+    if( !bench_init_gfx("tiled") ) {
+        return false;
+    }
+    struct disk_t { int x, y, r; uint8_t c[4]; };
+    struct triangle_t { int x1, y1, x2, y2, x3, y3; uint8_t c[4]; };
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> rnd_x(-40, pixel::fb_width + 40), rnd_y(-40, pixel::fb_height + 40),
+                                       rnd_r(2, 40), rnd_d(-60, 60), rnd_c(0, 255);
+    std::vector<disk_t> disk_list;
+    std::vector<triangle_t> triangle_list;
+    for(size_t i=0; i<disks; ++i) {
+        disk_list.push_back( disk_t { rnd_x(rng), rnd_y(rng), rnd_r(rng), { uint8_t(rnd_c(rng)), uint8_t(rnd_c(rng)), uint8_t(rnd_c(rng)), 255 } } );
+    }
+    for(size_t i=0; i<triangles; ++i) {
+        const int x = rnd_x(rng), y = rnd_y(rng);
+        triangle_list.push_back( triangle_t { x, y, x + rnd_d(rng), y + rnd_d(rng), x + rnd_d(rng), y + rnd_d(rng),
+                                              { uint8_t(rnd_c(rng)), uint8_t(rnd_c(rng)), uint8_t(rnd_c(rng)), 255 } } );
+    }
+    // interleaved disks and triangles, overlapping in submission order
+    auto frame = [&]() {
+        pixel::clear_pixel_fb(255, 255, 255, 255);
+        for(size_t i=0; i<std::max(disks, triangles); ++i) {
+            if( i < disks ) {
+                const disk_t& d = disk_list[i];
+                pixel::set_pixel_color(d.c);
+                pixel::fill_disk_fbcoord(d.x, d.y, d.r);
+            }
+            if( i < triangles ) {
+                const triangle_t& t = triangle_list[i];
+                pixel::set_pixel_color(t.c);
+                pixel::fill_triangle_fbcoord(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3);
+            }
+        }
+        pixel::fb_tiles_flush();
+    };
+    const unsigned int hw_threads = std::max(1u, std::thread::hardware_concurrency());
+    printf("tiled: %dx%d, %zu disks and %zu triangles per frame, %u hardware threads\n",
+           pixel::fb_width, pixel::fb_height, disks, triangles, hw_threads);
+    printf("  %-10s %12s %10s %10s\n", "threads", "ms/frame", "speedup", "identical");
+    pixel::set_fb_tiled(0);
+    const double t_immediate = bench_ns(frame, 500.0);
+    const pixel::pixel_buffer_t reference = pixel::fb_pixels;
+    printf("  %-10s %12.2f %9.2fx %10s\n", "immediate", t_immediate / 1e6, 1.0, "-");
+    bool ok = true;
+    std::vector<unsigned int> thread_counts = { 1, 2, 4 };
+    if( hw_threads > 4 ) {
+        thread_counts.push_back(hw_threads);
+    }
+    for(const unsigned int threads : thread_counts) {
+        pixel::set_fb_tiled(threads);
+        const double t_tiled = bench_ns(frame, 500.0);
+        const bool identical = reference == pixel::fb_pixels;
+        ok = ok && identical;
+        printf("  %-10u %12.2f %9.2fx %10s\n", threads, t_tiled / 1e6, t_immediate / t_tiled, identical ? "yes" : "NO");
+    }
+    pixel::set_fb_tiled(0);
+    return ok;
+}
+
+//
+// broadphase: f2::grid_index_t vs linear scan
+//
+
+static bool bench_broadphase() {
+    constexpr float extent = 1000.0f, cell_size = 32.0f;
+    printf("broadphase: moving boxes of size [1..20] within +-%.0f, grid cell size %.0f, box query per object and frame\n", extent, cell_size);
+    printf("  %-8s %14s %14s %10s   [us/frame]\n", "objects", "grid_index_t", "linear scan", "speedup");
+    bool ok = true;
+    for(const size_t count : { size_t(500), size_t(5000) }) {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> rnd_pos(-extent, extent), rnd_size(1.0f, 20.0f), rnd_velo(-1.0f, 1.0f);
+        std::vector<std::shared_ptr<f2::aabbox_t>> boxes;
+        std::vector<f2::vec_t> velo;
+        f2::geom_list_t all;
+        f2::grid_index_t grid(cell_size);
+        for(size_t i=0; i<count; ++i) {
+            const f2::point_t bl(rnd_pos(rng), rnd_pos(rng));
+            std::shared_ptr<f2::aabbox_t> b = std::make_shared<f2::aabbox_t>(bl, bl + f2::vec_t(rnd_size(rng), rnd_size(rng)));
+            boxes.push_back(b);
+            velo.emplace_back(rnd_velo(rng), rnd_velo(rng));
+            all.push_back(b);
+            grid.insert(b);
+        }
+        auto move = [&]() {
+            for(size_t i=0; i<count; ++i) {
+                f2::aabbox_t& b = *boxes[i];
+                if( b.bl.x < -extent || b.tr.x > extent ) { velo[i].x = -velo[i].x; }
+                if( b.bl.y < -extent || b.tr.y > extent ) { velo[i].y = -velo[i].y; }
+                b.bl += velo[i];
+                b.tr += velo[i];
+            }
+        };
+        f2::geom_list_t res;
+        auto grid_frame = [&]() -> size_t {
+            size_t hits = 0;
+            grid.update_all();
+            for(const std::shared_ptr<f2::aabbox_t>& b : boxes) {
+                res.clear();
+                hits += grid.query(res, *b);
+            }
+            return hits;
+        };
+        auto scan_frame = [&]() -> size_t {
+            size_t hits = 0;
+            for(const std::shared_ptr<f2::aabbox_t>& b : boxes) {
+                for(const f2::geom_ref_t& g : all) {
+                    hits += g->box().intersects(*b);
+                }
+            }
+            return hits;
+        };
+        const double t_grid = bench_ns([&]() { move(); bench_sink = bench_sink + grid_frame(); });
+        const double t_scan = bench_ns([&]() { move(); bench_sink = bench_sink + scan_frame(); });
+        move();
+        const size_t grid_hits = grid_frame(), scan_hits = scan_frame();
+        if( grid_hits != scan_hits ) {
+            fprintf(stderr, "broadphase: %zu objects, grid_index_t found %zu pairs, linear scan %zu\n", count, grid_hits, scan_hits);
+            ok = false;
+        }
+        printf("  %-8zu %14.1f %14.1f %9.1fx\n", count, t_grid / 1e3, t_scan / 1e3, t_scan / t_grid);
+    }
+    return ok;
+}
+
+//
+// points: lineseg_t::for_all_points() template visitor vs point_action_t
+//
+
+static bool bench_points() {
+    if( !bench_init_gfx("points") ) {
+        return false;
+    }
+    printf("points: lineseg_t::for_all_points() per visited point\n");
+    printf("  %-8s %10s %14s %14s   [ns/point]\n", "type", "points", "template", "point_action_t");
+    bool ok = true;
+    {
+        const i2::point_t p0(0, 0), p1(997, 613);
+        size_t n_tmpl = 0, n_func = 0;
+        int64_t sum = 0;
+        const double t_tmpl = bench_ns([&]() {
+            n_tmpl = 0;
+            i2::lineseg_t::for_all_points(p0, p1, [&](const i2::point_t& p) -> bool { sum += p.x ^ p.y; ++n_tmpl; return true; });
+        });
+        const i2::lineseg_t::point_action_t action = [&](const i2::point_t& p) -> bool { sum += p.x ^ p.y; ++n_func; return true; };
+        const double t_func = bench_ns([&]() {
+            n_func = 0;
+            i2::lineseg_t::for_all_points(p0, p1, action);
+        });
+        bench_sink = bench_sink + uint64_t(sum);
+        ok = ok && n_tmpl == n_func && n_tmpl > 0;
+        printf("  %-8s %10zu %14.2f %14.2f\n", "i2", n_tmpl, t_tmpl / double(n_tmpl), t_func / double(n_func));
+    }
+    {
+        const f2::point_t p0(cart_coord.min_x() * 0.9f, cart_coord.min_y() * 0.9f), p1(cart_coord.max_x() * 0.9f, cart_coord.max_y() * 0.9f);
+        size_t n_tmpl = 0, n_func = 0;
+        double sum = 0;
+        const double t_tmpl = bench_ns([&]() {
+            n_tmpl = 0;
+            f2::lineseg_t::for_all_points(p0, p1, [&](const f2::point_t& p) -> bool { sum += p.x * p.y; ++n_tmpl; return true; });
+        });
+        const f2::lineseg_t::point_action_t action = [&](const f2::point_t& p) -> bool { sum += p.x * p.y; ++n_func; return true; };
+        const double t_func = bench_ns([&]() {
+            n_func = 0;
+            f2::lineseg_t::for_all_points(p0, p1, action);
+        });
+        bench_sink = bench_sink + uint64_t(sum != 0);
+        ok = ok && n_tmpl == n_func && n_tmpl > 0;
+        printf("  %-8s %10zu %14.2f %14.2f\n", "f2", n_tmpl, t_tmpl / double(n_tmpl), t_func / double(n_func));
+    }
+    return ok;
+}
+
+//
+// main
+//
+
+struct section_t {
+    const char* name;
+    bool (*run)();
+};
+
+static const section_t sections[] = {
+    { "kernels", bench_kernels },
+    { "fb", bench_fb },
+    { "tiled", bench_tiled },
+    { "broadphase", bench_broadphase },
+    { "points", bench_points },
+};
+
+int main(int argc, char *argv[]) {
+    bench_exe = argv[0];
+    bool ok = true;
+    for(const section_t& s : sections) {
+        bool selected = argc < 2;
+        for(int i=1; i<argc; ++i) {
+            selected = selected || 0 == strcmp(argv[i], s.name);
+        }
+        if( selected && !s.run() ) {
+            fprintf(stderr, "%s: FAILED\n", s.name);
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2022 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * Build tool writing all files of an asset directory into one packed asset archive,
+ * see pixel/asset_archive.hpp and pixel::open_asset_archive().
+ */
+#include "pixel/asset_archive.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace pixel;
+
+struct pack_entry_t {
+    std::string name;
+    fs::path path;
+    archive::entry_t e;
+};
+
+static uint64_t align_up(const uint64_t v, const uint64_t a) {
+    return ( v + a - 1 ) / a * a;
+}
+
+static bool write_zeros(std::ofstream& out, uint64_t n) {
+    static const char zeros[archive::data_alignment] = { 0 };
+    while( n > 0 ) {
+        const uint64_t c = std::min<uint64_t>(n, sizeof(zeros));
+        out.write(zeros, std::streamsize(c));
+        n -= c;
+    }
+    return out.good();
+}
+
+int main(int argc, char *argv[]) {
+    if( 3 != argc ) {
+        fprintf(stderr, "Usage: %s <archive-file> <asset-dir>\n", argv[0]);
+        return 1;
+    }
+    const fs::path out_file = argv[1];
+    const fs::path asset_dir = argv[2];
+    std::error_code ec;
+    if( !fs::is_directory(asset_dir, ec) ) {
+        fprintf(stderr, "Not a directory: %s\n", asset_dir.c_str());
+        return 1;
+    }
+    std::vector<pack_entry_t> entries;
+    for(const fs::directory_entry& de : fs::recursive_directory_iterator(asset_dir, ec)) {
+        if( !de.is_regular_file() ) {
+            continue;
+        }
+        const std::string name = fs::relative(de.path(), asset_dir).generic_string();
+        if( name.empty() || '.' == name[0] || archive::default_name == name ) {
+            continue;
+        }
+        pack_entry_t p { .name=name, .path=de.path(), .e={} };
+        p.e.hash = archive::hash(name);
+        p.e.length = de.file_size();
+        p.e.format = archive::format_of(name);
+        entries.push_back(std::move(p));
+    }
+    if( ec ) {
+        fprintf(stderr, "Error reading %s: %s\n", asset_dir.c_str(), ec.message().c_str());
+        return 1;
+    }
+    std::sort(entries.begin(), entries.end(), [](const pack_entry_t& a, const pack_entry_t& b) {
+        return a.e.hash != b.e.hash ? a.e.hash < b.e.hash : a.name < b.name;
+    });
+
+    archive::header_t h;
+    std::memcpy(h.magic, archive::magic, sizeof(h.magic));
+    h.version = archive::version;
+    h.count = uint32_t(entries.size());
+    h.index_offset = sizeof(archive::header_t);
+    h.names_offset = h.index_offset + entries.size() * sizeof(archive::entry_t);
+    uint64_t names_size = 0;
+    for(pack_entry_t& p : entries) {
+        p.e.name_offset = uint32_t(names_size);
+        p.e.name_length = uint32_t(p.name.size());
+        names_size += p.name.size();
+    }
+    uint64_t offset = align_up(h.names_offset + names_size, archive::data_alignment);
+    for(pack_entry_t& p : entries) {
+        p.e.offset = offset;
+        offset = align_up(offset + p.e.length, archive::data_alignment);
+    }
+
+    std::ofstream out(out_file, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for(const pack_entry_t& p : entries) {
+        out.write(reinterpret_cast<const char*>(&p.e), sizeof(p.e));
+    }
+    for(const pack_entry_t& p : entries) {
+        out.write(p.name.data(), std::streamsize(p.name.size()));
+    }
+    uint64_t pos = h.names_offset + names_size;
+    std::vector<char> data;
+    for(const pack_entry_t& p : entries) {
+        write_zeros(out, p.e.offset - pos);
+        data.resize(p.e.length);
+        std::ifstream in(p.path, std::ios::binary);
+        if( !in.read(data.data(), std::streamsize(data.size())) ) {
+            fprintf(stderr, "Error reading %s\n", p.path.c_str());
+            return 1;
+        }
+        out.write(data.data(), std::streamsize(data.size()));
+        pos = p.e.offset + p.e.length;
+        printf("%8zu bytes @ %8zu, %-7s %s\n", size_t(p.e.length), size_t(p.e.offset), archive::to_string(p.e.format), p.name.c_str());
+    }
+    if( !out.good() ) {
+        fprintf(stderr, "Error writing %s\n", out_file.c_str());
+        return 1;
+    }
+    printf("%s: %zu assets, %zu bytes\n", out_file.c_str(), entries.size(), size_t(pos));
+    return 0;
+}